@@ -0,0 +1,52 @@
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+
+#include <string>
+#include "include/jada.hpp"
+
+using namespace jada;
+
+template <size_t N>
+void halo_exchange_benchmarks(std::array<index_type, N> dims, index_type pad) {
+
+    Box<N> domain{};
+    domain.end = dims;
+
+    std::array<bool, N> periods{};
+    periods.fill(true);
+
+    std::array<index_type, N> bpad{};
+    bpad.fill(pad);
+
+    const auto topo = decompose(domain, mpi::world_size(), periods);
+    const auto rank = mpi::get_world_rank();
+
+    std::vector<int> data(size_t(volume(domain)), 1);
+    auto             arr = distribute(data, topo, rank, bpad, bpad);
+
+    auto postfix = std::to_string(N) + "D " + std::to_string(dims[0]) +
+                   " pad " + std::to_string(pad);
+
+    BENCHMARK("one-shot " + postfix) {
+        mpi_send_receive(arr);
+        return arr.get_local_data().size();
+    };
+
+    auto packed = make_exchange_plan(arr, ExchangeMethod::Pack);
+    BENCHMARK("plan pack " + postfix) {
+        mpi_send_receive(arr, packed);
+        return arr.get_local_data().size();
+    };
+
+    auto subarray = make_exchange_plan(arr, ExchangeMethod::Subarray);
+    BENCHMARK("plan subarray " + postfix) {
+        mpi_send_receive(arr, subarray);
+        return arr.get_local_data().size();
+    };
+}
+
+TEST_CASE("Halo exchange") {
+
+    halo_exchange_benchmarks<2>({128, 128}, 2);
+    halo_exchange_benchmarks<3>({32, 32, 32}, 2);
+}
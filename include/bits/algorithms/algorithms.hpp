@@ -1,6 +1,13 @@
 #pragma once
 
+#include "blocking.hpp"
 #include "for_each.hpp"
+#include "fused_transform.hpp"
+#include "multi_reduce.hpp"
+#include "reduce.hpp"
+#include "simd_tile_transform.hpp"
+#include "stencil_transform.hpp"
+#include "temporal_transform.hpp"
 #include "tile_transform.hpp"
 #include "transform.hpp"
 #include "window_transform.hpp"
\ No newline at end of file
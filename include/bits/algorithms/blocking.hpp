@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+
+#include "include/bits/core/core.hpp"
+
+#ifndef JADA_CACHE_BYTES
+// Per-core cache size targeted by the automatic block sizes
+#define JADA_CACHE_BYTES (1024 * 1024)
+#endif
+
+namespace jada {
+
+///
+///@brief Selects the blocked traversal of the stencil algorithms. The index
+/// space is processed in blocks of extent 'block', so that the neighbouring
+/// planes accessed by a stencil are reused from cache. The block size is
+/// chosen automatically from 'cache_bytes', the element size and the stencil
+/// footprint in each direction where 'block' is zero.
+///
+///@tparam N the rank of the traversed spans
+///
+template <size_t N> struct Blocked {
+    std::array<index_type, N> block{};
+    size_t                    cache_bytes = JADA_CACHE_BYTES;
+};
+
+namespace detail {
+
+///
+///@brief Chooses the block size for traversing an index space of extent
+/// 'dims' with a stencil accessing offsets [min, max] of elements of size
+/// 'element_size'. The first direction is streamed through in full and the
+/// other directions are halved, the last (contiguous) one last, until the
+/// stencil planes of the block cross-section fit in half of the cache. The
+/// given non-zero block sizes are kept as is.
+///
+///@param dims the extent of the traversed index space
+///@param element_size the size of the input elements in bytes
+///@param min the minimum offsets accessed by the stencil
+///@param max the maximum offsets accessed by the stencil
+///@param traversal the requested blocking
+///@return std::array<index_type, N> the block size, positive in all directions
+///
+template <size_t N>
+static constexpr std::array<index_type, N>
+choose_block_size(std::array<index_type, N> dims,
+                  size_t                    element_size,
+                  std::array<index_type, N> min,
+                  std::array<index_type, N> max,
+                  Blocked<N>                traversal) {
+
+    // Rows shorter than this are not split to keep the inner loop vectorized
+    constexpr index_type min_row = 32;
+
+    std::array<index_type, N> block = dims;
+
+    auto fixed = [&](size_t i) { return traversal.block[i] > 0; };
+
+    auto bytes = [&]() {
+        size_t ret = element_size * size_t(max[0] - min[0] + 1);
+        for (size_t i = 1; i < N; ++i) {
+            ret *= size_t(block[i] + max[i] - min[i]);
+        }
+        return ret;
+    };
+
+    auto shrink = [&](size_t i, index_type smallest) {
+        if (fixed(i) || block[i] <= smallest) { return false; }
+        block[i] = std::max(smallest, block[i] / 2);
+        return true;
+    };
+
+    for (size_t i = 0; i < N; ++i) {
+        if (fixed(i)) { block[i] = traversal.block[i]; }
+    }
+
+    while (bytes() > traversal.cache_bytes / 2) {
+
+        // the largest of the middle directions
+        size_t largest = 0;
+        for (size_t i = 1; i + 1 < N; ++i) {
+            if (!fixed(i) && (largest == 0 || block[i] > block[largest])) {
+                largest = i;
+            }
+        }
+
+        if (largest != 0 && shrink(largest, 1)) { continue; }
+        if (N > 1 && shrink(N - 1, min_row)) { continue; }
+        break;
+    }
+
+    for (auto& b : block) { b = std::max(b, index_type(1)); }
+    return block;
+}
+
+} // namespace detail
+
+} // namespace jada
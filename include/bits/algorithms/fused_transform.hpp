@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <execution>
+#include <tuple>
+#include <type_traits>
+
+#include "include/bits/algorithms/tile_transform.hpp"
+#include "include/bits/algorithms/window_transform.hpp"
+
+namespace jada {
+
+///
+///@brief A window operation evaluated as a part of a fused_transform. The
+/// window accessor has the same rank as the transformed spans.
+///
+template <class UnaryWindowFunction> struct WindowTerm {
+
+    UnaryWindowFunction f;
+
+    constexpr auto operator()(auto idx, auto span) const {
+        return f(make_subspan(span, idx));
+    }
+
+    ///
+    ///@brief Returns the minimum and maximum offsets accessed by the term.
+    ///
+    template <size_t N> constexpr auto offsets() const {
+        return md_min_max_offset<N>(f);
+    }
+};
+
+///
+///@brief A tile operation along direction Dir evaluated as a part of a
+/// fused_transform. The tile accessor is one dimensional.
+///
+template <size_t Dir, class UnaryTileFunction> struct TileTerm {
+
+    UnaryTileFunction f;
+
+    constexpr auto operator()(auto idx, auto span) const {
+        return f(idxhandle_md_to_oned<Dir>(span, idx));
+    }
+
+    ///
+    ///@brief Returns the minimum and maximum offsets accessed by the term.
+    ///
+    template <size_t N> constexpr auto offsets() const {
+        static_assert(Dir < N, "Tile direction out of bounds");
+        const auto [tmin, tmax] = min_max_offset(f);
+
+        std::array<index_type, N> min{};
+        std::array<index_type, N> max{};
+        min[Dir] = tmin;
+        max[Dir] = tmax;
+        return std::make_pair(min, max);
+    }
+};
+
+/// @brief Makes a window term for fused_transform.
+/// @param f the unary window operation. Example: f = [](auto accessor){return
+/// accessor(1,0) + accessor(-1,0);};
+/// @return the window term
+template <class UnaryWindowFunction>
+static constexpr auto window_term(UnaryWindowFunction f) {
+    return WindowTerm<UnaryWindowFunction>{f};
+}
+
+/// @brief Makes a tile term along direction Dir for fused_transform.
+/// @tparam Dir the direction (index) along which the tile is created.
+/// @param f the unary tile operation. Example: f = [](auto accessor){return
+/// accessor(0) + accessor(1);};
+/// @return the tile term
+template <size_t Dir, class UnaryTileFunction>
+static constexpr auto tile_term(UnaryTileFunction f) {
+    return TileTerm<Dir, UnaryTileFunction>{f};
+}
+
+namespace detail {
+
+///
+///@brief Returns the minimum and maximum offsets accessed by any of the terms.
+///
+template <size_t N, class... Terms>
+static constexpr auto fused_offsets(const Terms&... terms) {
+
+    std::array<index_type, N> min{};
+    std::array<index_type, N> max{};
+
+    auto add = [&](const auto& term) {
+        const auto [tmin, tmax] = term.template offsets<N>();
+        for (size_t i = 0; i < N; ++i) {
+            min[i] = std::min(min[i], tmin[i]);
+            max[i] = std::max(max[i], tmax[i]);
+        }
+    };
+    (add(terms), ...);
+
+    return std::make_pair(min, max);
+}
+
+} // namespace detail
+
+/// @brief Evaluates all the input window and tile terms at every element of the
+/// input span and stores the result of combining them into the output span,
+/// i.e. o_span(idx) = combiner(term1(idx), term2(idx), ...). All the terms are
+/// evaluated in a single traversal, so no intermediate arrays are needed for
+/// the results of the individual terms. Executed according to policy (not
+/// necessarily in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param i_span the input span.
+/// @param o_span the output span.
+/// @param combiner function object taking the values of all the terms and
+/// returning a type corresponding to the value_type of o_span.
+/// @param terms the window_term and tile_term operations to evaluate.
+template <class ExecutionPolicy,
+          class InputSpan,
+          class OutputSpan,
+          class Combiner,
+          class... Terms>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+static constexpr void fused_transform(ExecutionPolicy&& policy,
+                                      InputSpan         i_span,
+                                      OutputSpan        o_span,
+                                      Combiner          combiner,
+                                      Terms... terms) {
+
+    static_assert(sizeof...(Terms) > 0, "No terms given to fused_transform");
+
+    const auto evaluate = [=](auto idx, auto span) {
+        return std::make_tuple(terms(idx, span)...);
+    };
+
+    const auto combine = [=](auto values) {
+        return std::apply(combiner, values);
+    };
+
+    detail::window_transform(policy, i_span, o_span, combine, evaluate);
+}
+
+/// @brief Evaluates all the input window and tile terms at every element of the
+/// input span and stores the result of combining them into the output span.
+/// Executed in order.
+/// @param i_span the input span.
+/// @param o_span the output span.
+/// @param combiner function object taking the values of all the terms.
+/// @param terms the window_term and tile_term operations to evaluate.
+template <class InputSpan, class OutputSpan, class Combiner, class... Terms>
+    requires(!std::is_execution_policy_v<std::remove_cvref_t<InputSpan>>)
+static constexpr void fused_transform(InputSpan  i_span,
+                                      OutputSpan o_span,
+                                      Combiner   combiner,
+                                      Terms... terms) {
+
+    fused_transform(std::execution::seq, i_span, o_span, combiner, terms...);
+}
+
+} // namespace jada
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <execution>
+#include <type_traits>
 
 #include "include/bits/core/core.hpp"
 /*
@@ -14,15 +15,149 @@ namespace jada {
 
 namespace detail {
 
+///
+///@brief Calls F(md_idx) for all md_idx in the box [begin, end). The index
+/// space is split into rows along the last (contiguous) dimension, the rows are
+/// distributed according to policy and each row is traversed with a plain loop
+/// which the compiler is free to vectorize. Only the first index of each row is
+/// computed with div/mod operations.
+///
+///@param policy the execution policy to use
+///@param begin the first index of the box
+///@param end one past the last index of the box
+///@param F the function to call for each multidimensional index
+///
+template <class ExecutionPolicy, size_t N, class UnaryMdIndexFunction>
+static constexpr void md_for_each(ExecutionPolicy&&         policy,
+                                  std::array<index_type, N> begin,
+                                  std::array<index_type, N> end,
+                                  UnaryMdIndexFunction      F) {
+
+    for (size_t i = 0; i < N; ++i) {
+        if (end[i] <= begin[i]) { return; }
+    }
+
+    if constexpr (N == 1) {
+        std::for_each_n(policy,
+                        counting_iterator(begin[0]),
+                        end[0] - begin[0],
+                        [=](index_type i) { F(std::array<index_type, 1>{i}); });
+    } else {
+
+        index_type row_count = 1;
+        for (size_t i = 0; i < N - 1; ++i) { row_count *= end[i] - begin[i]; }
+
+        auto row = [=](index_type r) {
+            std::array<index_type, N> md_idx{};
+            for (size_t i = N - 1; i-- > 0;) {
+                const auto n = end[i] - begin[i];
+                md_idx[i]    = begin[i] + r % n;
+                r /= n;
+            }
+            for (index_type i = begin[N - 1]; i < end[N - 1]; ++i) {
+                md_idx[N - 1] = i;
+                F(md_idx);
+            }
+        };
+
+        std::for_each_n(policy, counting_iterator(index_type(0)), row_count, row);
+    }
+}
+
+///
+///@brief Calls F(md_idx) for all md_idx in the view of multidimensional
+/// indices. The view is a cartesian product of index ranges (see md_indices),
+/// so it is traversed as the box between its first and last index.
+///
+///@param policy the execution policy to use
+///@param indices the view of multidimensional indices
+///@param F the function to call for each multidimensional index
+///
 template <class ExecutionPolicy, class Indices, class UnaryMdIndexFunction>
-static constexpr void md_for_each(ExecutionPolicy&&     policy,
-                                      Indices               indices,
-                                      UnaryMdIndexFunction F) {
-
-    std::for_each_n(policy,
-                    counting_iterator(index_type(0)),
-                    indices.size(),
-                    [=](index_type i) { F(tuple_to_array(indices[i])); });
+static constexpr void md_for_each(ExecutionPolicy&&    policy,
+                                  Indices              indices,
+                                  UnaryMdIndexFunction F) {
+
+    const auto size = static_cast<index_type>(indices.size());
+    if (size == 0) { return; }
+
+    const auto begin = tuple_to_array(indices[0]);
+    auto       end   = tuple_to_array(indices[size - 1]);
+    for (auto& e : end) { ++e; }
+
+    md_for_each(policy, begin, end, F);
+}
+
+///
+///@brief Calls f(i) for i in [0, n), concurrently unless the policy is
+/// sequenced. The loop itself is never vectorized so that f may call parallel
+/// algorithms with the same policy. Used for processing independent tasks which
+/// are large enough to be parallelized themselves.
+///
+///@param policy the execution policy of the tasks
+///@param n the number of iterations
+///@param f the function to call for each index
+///
+template <class ExecutionPolicy, class F>
+void for_each_concurrent(ExecutionPolicy&& policy, size_t n, F f) {
+
+    (void)policy;
+    using P = std::remove_cvref_t<ExecutionPolicy>;
+    if constexpr (std::is_same_v<P, std::execution::sequenced_policy> ||
+                  std::is_same_v<P, std::execution::unsequenced_policy>) {
+        for (size_t i = 0; i < n; ++i) { f(i); }
+    } else {
+        std::for_each_n(std::execution::par,
+                        counting_iterator(index_type(0)),
+                        n,
+                        [=](index_type i) { f(size_t(i)); });
+    }
+}
+
+///
+///@brief Calls F(md_idx) for all md_idx in the box [begin, end) one block of
+/// extent 'block' at a time. The blocks are distributed according to policy
+/// and the indices of each block are traversed in order, so that the data
+/// touched by a block stays in cache while the block is processed.
+///
+///@param policy the execution policy to use
+///@param begin the first index of the box
+///@param end one past the last index of the box
+///@param block the extent of the blocks, must be positive
+///@param F the function to call for each multidimensional index
+///
+template <class ExecutionPolicy, size_t N, class UnaryMdIndexFunction>
+static constexpr void md_for_each_blocked(ExecutionPolicy&&         policy,
+                                          std::array<index_type, N> begin,
+                                          std::array<index_type, N> end,
+                                          std::array<index_type, N> block,
+                                          UnaryMdIndexFunction      F) {
+
+    std::array<index_type, N> counts{};
+    index_type                block_count = 1;
+    for (size_t i = 0; i < N; ++i) {
+        runtime_assert(block[i] > 0, "Non-positive block size");
+        if (end[i] <= begin[i]) { return; }
+        counts[i] = (end[i] - begin[i] + block[i] - 1) / block[i];
+        block_count *= counts[i];
+    }
+
+    if (block_count == 1) {
+        md_for_each(policy, begin, end, F);
+        return;
+    }
+
+    for_each_concurrent(policy, size_t(block_count), [=](size_t b) {
+        auto                      r = index_type(b);
+        std::array<index_type, N> b_begin{};
+        std::array<index_type, N> b_end{};
+        for (size_t i = N; i-- > 0;) {
+            b_begin[i] = begin[i] + (r % counts[i]) * block[i];
+            b_end[i]   = std::min(b_begin[i] + block[i], end[i]);
+            r /= counts[i];
+        }
+        md_for_each(std::execution::seq, b_begin, b_end, F);
+    });
 }
 
 } // namespace detail
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <execution>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "include/bits/algorithms/reduce.hpp"
+
+namespace jada {
+
+///
+///@brief A single reduction evaluated as a part of a multi_reduce. Each
+/// element is first mapped with 'transform' and the results are reduced with
+/// 'op' starting from 'init'.
+///
+///@tparam T the type of the result
+///@tparam BinaryReductionOp the reduction operation
+///@tparam UnaryTransformOp the transform applied to each element
+///
+template <class T, class BinaryReductionOp, class UnaryTransformOp>
+struct Reducer {
+    T                 init;
+    BinaryReductionOp op;
+    UnaryTransformOp  transform;
+};
+
+/// @brief Makes a reducer for multi_reduce.
+/// @param init the initial value of the reduction.
+/// @param op the binary reduction operation, e.g. std::plus<>{}.
+/// @param transform the unary function applied to each element before the
+/// reduction (defaults to the identity).
+/// @return the reducer
+template <class T,
+          class BinaryReductionOp,
+          class UnaryTransformOp = Identity>
+static constexpr auto make_reducer(T                 init,
+                                   BinaryReductionOp op,
+                                   UnaryTransformOp  transform = {}) {
+    return Reducer<T, BinaryReductionOp, UnaryTransformOp>{init, op, transform};
+}
+
+///
+///@brief Transform returning the square of its argument.
+///
+template <class T> struct Square {
+    constexpr T operator()(const auto& v) const { return T(v) * T(v); }
+};
+
+///
+///@brief Transform returning the absolute value of its argument.
+///
+template <class T> struct Absolute {
+    constexpr T operator()(const auto& v) const {
+        return T(v) < T(0) ? -T(v) : T(v);
+    }
+};
+
+/// @brief Makes a reducer computing the sum of the elements.
+template <class T> static constexpr auto sum_reducer() {
+    return make_reducer(T(0), std::plus<>{});
+}
+
+/// @brief Makes a reducer computing the sum of the squares of the elements,
+/// i.e. the square of the l2 norm.
+template <class T> static constexpr auto sum_of_squares_reducer() {
+    return make_reducer(T(0), std::plus<>{}, Square<T>{});
+}
+
+/// @brief Makes a reducer computing the maximum of the elements.
+template <class T> static constexpr auto max_reducer() {
+    return make_reducer(std::numeric_limits<T>::lowest(), Maximum{});
+}
+
+/// @brief Makes a reducer computing the minimum of the elements.
+template <class T> static constexpr auto min_reducer() {
+    return make_reducer(std::numeric_limits<T>::max(), Minimum{});
+}
+
+/// @brief Makes a reducer computing the maximum absolute value of the
+/// elements, i.e. the max norm.
+template <class T> static constexpr auto max_abs_reducer() {
+    return make_reducer(T(0), Maximum{}, Absolute<T>{});
+}
+
+namespace detail {
+
+///
+///@brief Applies the reduction operations Ops elementwise to tuples of
+/// partial results.
+///
+template <class... Ops> struct TupleReductionOp {
+
+    std::tuple<Ops...> ops{};
+
+    template <class... Ts>
+    constexpr std::tuple<Ts...> operator()(const std::tuple<Ts...>& lhs,
+                                           const std::tuple<Ts...>& rhs) const {
+        return apply(lhs, rhs, std::index_sequence_for<Ts...>{});
+    }
+
+private:
+    template <class Tuple, size_t... Is>
+    constexpr Tuple
+    apply(const Tuple& lhs, const Tuple& rhs, std::index_sequence<Is...>) const {
+        return Tuple{std::get<Is>(ops)(std::get<Is>(lhs), std::get<Is>(rhs))...};
+    }
+};
+
+///
+///@brief Returns the combined reduction operation of the reducers.
+///
+template <class... Reducers>
+static constexpr auto tuple_reduction_op(const Reducers&... reducers) {
+    return TupleReductionOp<decltype(reducers.op)...>{
+        std::make_tuple(reducers.op...)};
+}
+
+///
+///@brief Returns a function mapping an element to the tuple of the
+/// transformed values of the reducers.
+///
+template <class... Reducers>
+static constexpr auto tuple_transform(const Reducers&... reducers) {
+    return [=](const auto& v) {
+        return std::tuple<decltype(reducers.init)...>{
+            decltype(reducers.init)(reducers.transform(v))...};
+    };
+}
+
+} // namespace detail
+
+/// @brief Computes several reductions of the elements of the span in a single
+/// traversal. Each reducer maps the elements with its own transform and
+/// reduces them with its own operation, so that e.g. the l2 norm, the max
+/// norm and the sum of a residual can be computed in one pass:
+/// auto [l2, max, sum] = multi_reduce(policy, span,
+/// sum_of_squares_reducer<double>(), max_abs_reducer<double>(),
+/// sum_reducer<double>()). Executed according to policy (not necessarily in
+/// order), so the reductions should be associative and commutative.
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param span the input span.
+/// @param reducers the reductions to compute, see make_reducer.
+/// @return std::tuple of the results of the reducers in the given order.
+template <class ExecutionPolicy, class Span, class... Reducers>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+static constexpr auto
+multi_reduce(ExecutionPolicy&& policy, Span span, Reducers... reducers) {
+
+    static_assert(sizeof...(Reducers) > 0, "No reducers given to multi_reduce");
+
+    return transform_reduce(policy,
+                            span,
+                            std::make_tuple(reducers.init...),
+                            detail::tuple_reduction_op(reducers...),
+                            detail::tuple_transform(reducers...));
+}
+
+/// @brief Computes several reductions of the elements of the span in a single
+/// traversal. Executed in order.
+/// @param span the input span.
+/// @param reducers the reductions to compute, see make_reducer.
+/// @return std::tuple of the results of the reducers in the given order.
+template <class Span, class... Reducers>
+    requires(!std::is_execution_policy_v<std::remove_cvref_t<Span>>)
+static constexpr auto multi_reduce(Span span, Reducers... reducers) {
+
+    return multi_reduce(std::execution::seq, span, reducers...);
+}
+
+} // namespace jada
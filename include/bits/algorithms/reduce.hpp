@@ -0,0 +1,239 @@
+#pragma once
+
+#include <algorithm>
+#include <execution>
+#include <functional>
+#include <type_traits>
+
+#include "include/bits/core/core.hpp"
+#include "include/bits/core/functional.hpp"
+
+namespace jada {
+
+namespace detail {
+
+///
+///@brief Reduces F(md_idx) for all md_idx in the box [begin, end) with the
+/// binary operation 'reduce' starting from 'init'. The box is split into rows
+/// along the last (contiguous) dimension, each row is reduced with a plain loop
+/// and the partial results of the rows are reduced according to policy. The
+/// order of the reduction is unspecified, so 'reduce' should be associative
+/// and commutative.
+///
+///@param policy the execution policy to use
+///@param begin the first index of the box
+///@param end one past the last index of the box
+///@param init the initial value of the reduction
+///@param reduce the binary reduction operation
+///@param F the function returning the value to reduce at md_idx
+///@return T the result of the reduction
+///
+template <class ExecutionPolicy,
+          size_t N,
+          class T,
+          class BinaryReductionOp,
+          class UnaryMdIndexFunction>
+static constexpr T md_transform_reduce(ExecutionPolicy&&         policy,
+                                       std::array<index_type, N> begin,
+                                       std::array<index_type, N> end,
+                                       T                         init,
+                                       BinaryReductionOp         reduce,
+                                       UnaryMdIndexFunction      F) {
+
+    for (size_t i = 0; i < N; ++i) {
+        if (end[i] <= begin[i]) { return init; }
+    }
+
+    if constexpr (N == 1) {
+        return std::transform_reduce(
+            policy,
+            counting_iterator(begin[0]),
+            counting_iterator(end[0]),
+            init,
+            reduce,
+            [=](index_type i) { return T(F(std::array<index_type, 1>{i})); });
+    } else {
+
+        index_type row_count = 1;
+        for (size_t i = 0; i < N - 1; ++i) { row_count *= end[i] - begin[i]; }
+
+        auto row = [=](index_type r) {
+            std::array<index_type, N> md_idx{};
+            for (size_t i = N - 1; i-- > 0;) {
+                const auto n = end[i] - begin[i];
+                md_idx[i]    = begin[i] + r % n;
+                r /= n;
+            }
+            md_idx[N - 1] = begin[N - 1];
+            T acc         = F(md_idx);
+            for (index_type i = begin[N - 1] + 1; i < end[N - 1]; ++i) {
+                md_idx[N - 1] = i;
+                acc           = reduce(acc, F(md_idx));
+            }
+            return acc;
+        };
+
+        return std::transform_reduce(policy,
+                                     counting_iterator(index_type(0)),
+                                     counting_iterator(row_count),
+                                     init,
+                                     reduce,
+                                     row);
+    }
+}
+
+///
+///@brief Returns the extent of the span as an index array.
+///
+template <class Span> static constexpr auto index_extent(Span span) {
+    constexpr size_t          N    = rank(span);
+    const auto                dims = dimensions(span);
+    std::array<index_type, N> ret{};
+    for (size_t i = 0; i < N; ++i) { ret[i] = index_type(dims[i]); }
+    return ret;
+}
+
+} // namespace detail
+
+/// @brief Applies the transform function to every element of the span and
+/// reduces the results with the binary reduction operation starting from init.
+/// The padding around a subspan is not visited. Executed according to policy
+/// (not necessarily in order), so the reduction should be associative and
+/// commutative.
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param span the input span.
+/// @param init the initial value of the reduction.
+/// @param reduce the binary reduction operation, e.g. std::plus<>{}.
+/// @param transform the unary function applied to each element before the
+/// reduction. Example: f = [](auto v){return v * v;};
+/// @return T the result of the reduction.
+template <class ExecutionPolicy,
+          class Span,
+          class T,
+          class BinaryReductionOp,
+          class UnaryTransformOp>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+static constexpr T transform_reduce(ExecutionPolicy&& policy,
+                                    Span              span,
+                                    T                 init,
+                                    BinaryReductionOp reduce,
+                                    UnaryTransformOp  transform) {
+
+    constexpr size_t N = rank(span);
+
+    return detail::md_transform_reduce(
+        policy,
+        std::array<index_type, N>{},
+        detail::index_extent(span),
+        init,
+        reduce,
+        [=](auto md_idx) { return transform(span(md_idx)); });
+}
+
+/// @brief Applies the transform function to every element of the span and
+/// reduces the results with the binary reduction operation starting from init.
+/// Executed in order.
+/// @param span the input span.
+/// @param init the initial value of the reduction.
+/// @param reduce the binary reduction operation, e.g. std::plus<>{}.
+/// @param transform the unary function applied to each element before the
+/// reduction.
+/// @return T the result of the reduction.
+template <class Span, class T, class BinaryReductionOp, class UnaryTransformOp>
+    requires(!std::is_execution_policy_v<std::remove_cvref_t<Span>>)
+static constexpr T transform_reduce(Span              span,
+                                    T                 init,
+                                    BinaryReductionOp reduce,
+                                    UnaryTransformOp  transform) {
+
+    return transform_reduce(
+        std::execution::seq, span, init, reduce, transform);
+}
+
+/// @brief Applies the function f(md_idx, value) to every element of the span
+/// and reduces the results with the binary reduction operation starting from
+/// init. Executed according to policy (not necessarily in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param span the input span.
+/// @param init the initial value of the reduction.
+/// @param reduce the binary reduction operation, e.g. std::plus<>{}.
+/// @param f the binary function taking the current multidimensional index as
+/// the first argument and the element as the second one.
+/// @return T the result of the reduction.
+template <class ExecutionPolicy,
+          class Span,
+          class T,
+          class BinaryReductionOp,
+          class BinaryIndexFunction>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+static constexpr T transform_reduce_indexed(ExecutionPolicy&&   policy,
+                                            Span                span,
+                                            T                   init,
+                                            BinaryReductionOp   reduce,
+                                            BinaryIndexFunction f) {
+
+    constexpr size_t N = rank(span);
+
+    return detail::md_transform_reduce(
+        policy,
+        std::array<index_type, N>{},
+        detail::index_extent(span),
+        init,
+        reduce,
+        [=](auto md_idx) { return f(md_idx, span(md_idx)); });
+}
+
+/// @brief Applies the function f(md_idx, value) to every element of the span
+/// and reduces the results with the binary reduction operation starting from
+/// init. Executed in order.
+/// @param span the input span.
+/// @param init the initial value of the reduction.
+/// @param reduce the binary reduction operation, e.g. std::plus<>{}.
+/// @param f the binary function taking the current multidimensional index as
+/// the first argument and the element as the second one.
+/// @return T the result of the reduction.
+template <class Span, class T, class BinaryReductionOp, class BinaryIndexFunction>
+    requires(!std::is_execution_policy_v<std::remove_cvref_t<Span>>)
+static constexpr T transform_reduce_indexed(Span                span,
+                                            T                   init,
+                                            BinaryReductionOp   reduce,
+                                            BinaryIndexFunction f) {
+
+    return transform_reduce_indexed(std::execution::seq, span, init, reduce, f);
+}
+
+/// @brief Reduces all elements of the span with the binary reduction operation
+/// starting from init. Executed according to policy (not necessarily in
+/// order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param span the input span.
+/// @param init the initial value of the reduction.
+/// @param op the binary reduction operation (defaults to addition).
+/// @return T the result of the reduction.
+template <class ExecutionPolicy,
+          class Span,
+          class T,
+          class BinaryReductionOp = std::plus<>>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+static constexpr T reduce(ExecutionPolicy&& policy,
+                          Span              span,
+                          T                 init,
+                          BinaryReductionOp op = {}) {
+
+    return transform_reduce(policy, span, init, op, Identity{});
+}
+
+/// @brief Reduces all elements of the span with the binary reduction operation
+/// starting from init. Executed in order.
+/// @param span the input span.
+/// @param init the initial value of the reduction.
+/// @param op the binary reduction operation (defaults to addition).
+/// @return T the result of the reduction.
+template <class Span, class T, class BinaryReductionOp = std::plus<>>
+    requires(!std::is_execution_policy_v<std::remove_cvref_t<Span>>)
+static constexpr T reduce(Span span, T init, BinaryReductionOp op = {}) {
+
+    return reduce(std::execution::seq, span, init, op);
+}
+
+} // namespace jada
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <type_traits>
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define JADA_HAS_SIMD
+#endif
+
+#include "include/bits/algorithms/md_for_each.hpp"
+#include "include/bits/algorithms/tile_transform.hpp"
+
+namespace jada {
+
+namespace detail {
+
+#ifdef JADA_HAS_SIMD
+
+namespace stdx = std::experimental;
+
+///
+///@brief One dimensional tile accessor loading W consecutive (innermost)
+/// elements at once. Indexing with an offset returns the W elements at
+/// 'offset' steps of 'stride' from the centers of the lanes.
+///
+template <class T> struct SimdTile {
+    using simd_type = stdx::native_simd<T>;
+
+    const T*   center;
+    index_type stride;
+
+    simd_type operator()(index_type offset) const {
+        simd_type ret;
+        ret.copy_from(center + offset * stride, stdx::element_aligned);
+        return ret;
+    }
+};
+
+#endif
+
+///
+///@brief One dimensional tile accessor for the scalar remainder of a row.
+///
+template <class T> struct ScalarTile {
+    const T*   center;
+    index_type stride;
+
+    T operator()(index_type offset) const { return center[offset * stride]; }
+};
+
+///
+///@brief Applies the tile function f to a single contiguous row of 'n'
+/// elements beginning at 'in' and stores the results to 'out'. The row is
+/// processed W lanes at a time with aligned stores, the unaligned head and the
+/// remainder of the row are processed one element at a time. If f can not be
+/// invoked with a SimdTile<T>, the whole row is processed one element at a
+/// time.
+///
+template <class T, class U, class UnaryTileFunction>
+static inline void simd_tile_row(const T*          in,
+                                 U*                out,
+                                 index_type        n,
+                                 index_type        stride,
+                                 UnaryTileFunction f) {
+
+    index_type i = 0;
+
+#ifdef JADA_HAS_SIMD
+    if constexpr (std::is_same_v<T, U> && std::is_arithmetic_v<T>) {
+
+        using simd_type = typename SimdTile<T>::simd_type;
+
+        if constexpr (std::is_invocable_r_v<simd_type,
+                                            UnaryTileFunction,
+                                            SimdTile<T>>) {
+
+            constexpr auto W     = index_type(simd_type::size());
+            constexpr auto align = stdx::memory_alignment_v<simd_type>;
+
+            // Peel until the stores are aligned
+            while (i < n &&
+                   reinterpret_cast<std::uintptr_t>(out + i) % align != 0) {
+                out[i] = f(ScalarTile<T>{in + i, stride});
+                ++i;
+            }
+
+            for (; i + W <= n; i += W) {
+                const simd_type result = f(SimdTile<T>{in + i, stride});
+                result.copy_to(out + i, stdx::vector_aligned);
+            }
+        }
+    }
+#endif
+
+    for (; i < n; ++i) { out[i] = f(ScalarTile<T>{in + i, stride}); }
+}
+
+} // namespace detail
+
+/// @brief Applies the input unary tile function to all elements of the input
+/// span and stores the result into the output span evaluating the tile
+/// function for several consecutive elements of the innermost direction at
+/// once. The tile accessor given to f returns a simd vector of values (or a
+/// single value for the remainders), so f should only use arithmetic operators
+/// on them, e.g. CD2: f = [](auto accessor){return accessor(-1) - 2 *
+/// accessor(0) + accessor(1);}. Note that simd vectors only mix with scalars
+/// which convert to the element type without loss, so the literal 2.0 in place
+/// of 2 would not compile for float elements. A tile function which declares
+/// its return type, e.g. -> decltype(accessor(-1) - 2.0 * accessor(0)), and
+/// can not be invoked with the simd accessor is evaluated one element at a
+/// time instead. If std::experimental::simd is not available or the innermost
+/// direction of the spans is not contiguous, the evaluation falls back to
+/// tile_transform. Executed according to policy (not necessarily in order).
+/// @tparam Dir the direction (index) along which the tile is created.
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param i_span the input span.
+/// @param o_span the output span.
+/// @param f the unary tile operation.
+template <size_t Dir,
+          class ExecutionPolicy,
+          class InputSpan,
+          class OutputSpan,
+          class UnaryTileFunction>
+static void simd_tile_transform(ExecutionPolicy&& policy,
+                                InputSpan         i_span,
+                                OutputSpan        o_span,
+                                UnaryTileFunction f) {
+
+    constexpr size_t N = rank(i_span);
+    static_assert(Dir < N, "Tile direction out of bounds");
+
+    runtime_assert(dimensions(i_span) == dimensions(o_span),
+                   "Dimension mismatch in simd_tile_transform()");
+
+    if (i_span.stride(N - 1) != 1 || o_span.stride(N - 1) != 1) {
+        tile_transform<Dir>(policy, i_span, o_span, f);
+        return;
+    }
+
+    const auto dims   = dimensions(i_span);
+    const auto n      = index_type(dims[N - 1]);
+    const auto stride = index_type(i_span.stride(Dir));
+
+    if (n == 0) { return; }
+
+    if constexpr (N == 1) {
+        detail::simd_tile_row(&i_span(0), &o_span(0), n, stride, f);
+    } else {
+
+        std::array<index_type, N - 1> end{};
+        for (size_t i = 0; i < N - 1; ++i) { end[i] = index_type(dims[i]); }
+
+        auto row = [=](std::array<index_type, N - 1> outer) {
+            std::array<index_type, N> md_idx{};
+            std::copy(outer.begin(), outer.end(), md_idx.begin());
+            detail::simd_tile_row(
+                &i_span(md_idx), &o_span(md_idx), n, stride, f);
+        };
+
+        detail::md_for_each(
+            policy, std::array<index_type, N - 1>{}, end, row);
+    }
+}
+
+/// @brief Applies the input unary tile function to all elements of the input
+/// span and stores the result into the output span evaluating the tile
+/// function for several consecutive elements of the innermost direction at
+/// once. Executed in order.
+/// @tparam Dir the direction (index) along which the tile is created.
+/// @param i_span the input span.
+/// @param o_span the output span.
+/// @param f the unary tile operation.
+template <size_t Dir,
+          class InputSpan,
+          class OutputSpan,
+          class UnaryTileFunction>
+static void
+simd_tile_transform(InputSpan i_span, OutputSpan o_span, UnaryTileFunction f) {
+
+    simd_tile_transform<Dir>(std::execution::seq, i_span, o_span, f);
+}
+
+} // namespace jada
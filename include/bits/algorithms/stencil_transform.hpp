@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <execution>
+#include <type_traits>
+#include <utility>
+
+#include "include/bits/algorithms/md_for_each.hpp"
+
+namespace jada {
+
+///
+///@brief A linear stencil with compile-time offsets and coefficients. The
+/// value at an index is the sum of coefficients[k] * value(index +
+/// offsets[k]). Meant to be used as a template argument, e.g.
+///
+/// constexpr Stencil<2, 5> laplace{
+///     {{{-1, 0}, {0, -1}, {0, 0}, {0, 1}, {1, 0}}},
+///     {1.0, 1.0, -4.0, 1.0, 1.0}};
+/// stencil_transform<laplace>(in, out);
+///
+///@tparam N the rank of the stencil
+///@tparam K the number of points in the stencil
+///@tparam T the type of the coefficients
+///
+template <size_t N, size_t K, class T = double> struct Stencil {
+
+    std::array<std::array<index_type, N>, K> offsets;
+    std::array<T, K>                         coefficients;
+
+    static constexpr size_t rank() { return N; }
+    static constexpr size_t size() { return K; }
+
+    ///
+    ///@brief Returns the minimum offsets in each direction, i.e. the negative
+    /// of the required begin padding.
+    ///
+    constexpr std::array<index_type, N> min() const {
+        std::array<index_type, N> ret{};
+        for (const auto& o : offsets) {
+            for (size_t i = 0; i < N; ++i) { ret[i] = std::min(ret[i], o[i]); }
+        }
+        return ret;
+    }
+
+    ///
+    ///@brief Returns the maximum offsets in each direction, i.e. the required
+    /// end padding.
+    ///
+    constexpr std::array<index_type, N> max() const {
+        std::array<index_type, N> ret{};
+        for (const auto& o : offsets) {
+            for (size_t i = 0; i < N; ++i) { ret[i] = std::max(ret[i], o[i]); }
+        }
+        return ret;
+    }
+
+    ///
+    ///@brief Returns the begin padding required by the stencil.
+    ///
+    constexpr std::array<index_type, N> begin_padding() const {
+        auto ret = min();
+        for (auto& r : ret) { r = -r; }
+        return ret;
+    }
+
+    ///
+    ///@brief Returns the end padding required by the stencil.
+    ///
+    constexpr std::array<index_type, N> end_padding() const { return max(); }
+};
+
+///
+///@brief Makes a one dimensional stencil of rank N along direction Dir.
+///
+///@tparam Dir the direction of the stencil
+///@tparam N the rank of the stencil
+///@param offsets the offsets along Dir
+///@param coefficients the coefficients of the offsets
+///@return Stencil<N, K, T> the stencil
+///
+template <size_t Dir, size_t N, class T, size_t K>
+static constexpr auto make_tile_stencil(std::array<index_type, K> offsets,
+                                        std::array<T, K> coefficients) {
+    static_assert(Dir < N, "Stencil direction out of bounds");
+
+    Stencil<N, K, T> ret{};
+    for (size_t k = 0; k < K; ++k) { ret.offsets[k][Dir] = offsets[k]; }
+    ret.coefficients = coefficients;
+    return ret;
+}
+
+namespace detail {
+
+///
+///@brief Computes the sum of coefficients[k] * row[i + flat[k]] with the loop
+/// over the stencil points fully unrolled.
+///
+template <auto S, class T, size_t... Ks>
+static constexpr auto
+stencil_point(const T*                                      row,
+              const std::array<index_type, sizeof...(Ks)>& flat,
+              std::index_sequence<Ks...>) {
+    return ((S.coefficients[Ks] * row[flat[Ks]]) + ...);
+}
+
+} // namespace detail
+
+/// @brief Applies the compile-time stencil S to all elements of the input span
+/// and stores scale times the result into the output span. The offsets of the
+/// stencil points are converted to flat memory offsets once, after which each
+/// point is a fully unrolled sum over constant offsets from a pointer advancing
+/// along the innermost direction. Executed according to policy (not
+/// necessarily in order).
+/// @tparam S the stencil, see Stencil.
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param i_span the input span, the padding around it must cover the offsets
+/// of S.
+/// @param o_span the output span.
+/// @param scale a runtime factor multiplying the result, e.g. 1 / (dx * dx).
+template <auto S,
+          class ExecutionPolicy,
+          class InputSpan,
+          class OutputSpan,
+          class Scale = double>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+static void stencil_transform(ExecutionPolicy&& policy,
+                              InputSpan         i_span,
+                              OutputSpan        o_span,
+                              Scale             scale = Scale(1)) {
+
+    constexpr size_t N = decltype(S)::rank();
+    constexpr size_t K = decltype(S)::size();
+
+    static_assert(rank(i_span) == N, "Rank mismatch in stencil_transform");
+
+    runtime_assert(dimensions(i_span) == dimensions(o_span),
+                   "Dimension mismatch in stencil_transform()");
+
+    const auto dims = dimensions(i_span);
+    for (size_t i = 0; i < N; ++i) {
+        if (dims[i] == 0) { return; }
+    }
+
+    std::array<index_type, K> flat{};
+    for (size_t k = 0; k < K; ++k) {
+        for (size_t i = 0; i < N; ++i) {
+            flat[k] += S.offsets[k][i] * index_type(i_span.stride(i));
+        }
+    }
+
+    const auto n        = index_type(dims[N - 1]);
+    const auto i_stride = index_type(i_span.stride(N - 1));
+    const auto o_stride = index_type(o_span.stride(N - 1));
+
+    auto row = [=](std::array<index_type, N> md_idx) {
+        const auto* in  = &i_span(md_idx);
+        auto*       out = &o_span(md_idx);
+        for (index_type i = 0; i < n; ++i) {
+            out[i * o_stride] =
+                scale * detail::stencil_point<S>(in + i * i_stride,
+                                                 flat,
+                                                 std::make_index_sequence<K>{});
+        }
+    };
+
+    if constexpr (N == 1) {
+        (void)policy;
+        row(std::array<index_type, 1>{});
+    } else {
+        std::array<index_type, N - 1> end{};
+        for (size_t i = 0; i < N - 1; ++i) { end[i] = index_type(dims[i]); }
+
+        detail::md_for_each(policy,
+                            std::array<index_type, N - 1>{},
+                            end,
+                            [=](std::array<index_type, N - 1> outer) {
+                                std::array<index_type, N> md_idx{};
+                                std::copy(
+                                    outer.begin(), outer.end(), md_idx.begin());
+                                row(md_idx);
+                            });
+    }
+}
+
+/// @brief Applies the compile-time stencil S to all elements of the input span
+/// and stores scale times the result into the output span. Executed in order.
+/// @tparam S the stencil, see Stencil.
+/// @param i_span the input span.
+/// @param o_span the output span.
+/// @param scale a runtime factor multiplying the result.
+template <auto S, class InputSpan, class OutputSpan, class Scale = double>
+    requires(!std::is_execution_policy_v<std::remove_cvref_t<InputSpan>>)
+static void stencil_transform(InputSpan  i_span,
+                              OutputSpan o_span,
+                              Scale      scale = Scale(1)) {
+
+    stencil_transform<S>(std::execution::seq, i_span, o_span, scale);
+}
+
+} // namespace jada
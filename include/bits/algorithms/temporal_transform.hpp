@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <execution>
+#include <type_traits>
+#include <vector>
+
+#include "include/bits/algorithms/blocking.hpp"
+#include "include/bits/algorithms/md_for_each.hpp"
+#include "include/bits/algorithms/window_transform.hpp"
+
+namespace jada {
+
+namespace detail {
+
+///
+///@brief Chooses the extent of the spatial tiles of a time-tiled stencil
+/// sweep. The two scratch buffers of a tile, including the ghost zone of
+/// 'reach' elements around it, should fit into the cache. The largest
+/// direction is halved until they do, keeping the tiles close to cubes which
+/// minimizes the redundant work in the ghost zones. Rows of the last
+/// (contiguous) direction are kept at least 32 elements long. The given
+/// non-zero sizes are kept.
+///
+///@param dims the extent of the updated region
+///@param element_size the size of the elements in bytes
+///@param reach the total ghost zone width (begin + end) in each direction
+///@param traversal the requested tiling
+///@return std::array<index_type, N> the tile size, positive in all directions
+///
+template <size_t N>
+static constexpr std::array<index_type, N>
+choose_tile_size(std::array<index_type, N> dims,
+                 size_t                    element_size,
+                 std::array<index_type, N> reach,
+                 Blocked<N>                traversal) {
+
+    constexpr index_type min_row = 32;
+
+    std::array<index_type, N> tile = dims;
+    for (size_t i = 0; i < N; ++i) {
+        if (traversal.block[i] > 0) { tile[i] = traversal.block[i]; }
+    }
+
+    auto bytes = [&]() {
+        size_t ret = 2 * element_size;
+        for (size_t i = 0; i < N; ++i) { ret *= size_t(tile[i] + reach[i]); }
+        return ret;
+    };
+
+    auto smallest = [&](size_t i) { return i + 1 == N ? min_row : 1; };
+
+    while (bytes() > traversal.cache_bytes) {
+
+        // Halve the largest direction to keep the redundant ghost zones small
+        size_t largest = N;
+        for (size_t i = 0; i < N; ++i) {
+            if (traversal.block[i] == 0 && tile[i] > smallest(i) &&
+                (largest == N || tile[i] > tile[largest])) {
+                largest = i;
+            }
+        }
+
+        if (largest == N) { break; }
+        tile[largest] = std::max(smallest(largest), tile[largest] / 2);
+    }
+
+    for (auto& t : tile) { t = std::max(t, index_type(1)); }
+    return tile;
+}
+
+///
+///@brief Advances the values of i_span 'steps' times with the window function
+/// f and stores the result into o_span. The values outside of i_span are kept
+/// fixed during the steps. On the sides where 'shrink_begin' or 'shrink_end'
+/// is set, the updated region shrinks by the stencil reach every step, so that
+/// i_span may extend into a deep halo of valid data. Only the region updated
+/// in the last step is written to o_span.
+///
+/// The final region is processed in spatial tiles. Each tile copies its ghost
+/// zone of 'steps' stencil reaches into two scratch buffers, advances all the
+/// steps there while the buffers stay in cache and writes the tile back. The
+/// ghost zones of neighbouring tiles overlap and are computed redundantly,
+/// which makes the tiles independent of each other.
+///
+template <class ExecutionPolicy,
+          class InputSpan,
+          class OutputSpan,
+          class UnaryWindowFunction,
+          size_t N>
+static void temporal_window_transform(ExecutionPolicy&&   policy,
+                                      InputSpan           i_span,
+                                      OutputSpan          o_span,
+                                      UnaryWindowFunction f,
+                                      size_t              steps,
+                                      std::array<bool, N> shrink_begin,
+                                      std::array<bool, N> shrink_end,
+                                      Blocked<N>          traversal) {
+
+    using T   = std::remove_cv_t<typename InputSpan::element_type>;
+    using idx = std::array<index_type, N>;
+
+    runtime_assert(steps > 0, "Zero steps in temporal_window_transform");
+    runtime_assert(dimensions(i_span) == dimensions(o_span),
+                   "Dimension mismatch in temporal_window_transform()");
+
+    const auto [min, max] = md_min_max_offset<N>(f);
+    const auto k          = index_type(steps);
+    const auto dims       = dimensions(i_span);
+
+    idx lo{};
+    idx hi{};
+    idx d{};
+    for (size_t i = 0; i < N; ++i) {
+        lo[i] = -min[i];
+        hi[i] = max[i];
+        d[i]  = index_type(dims[i]);
+    }
+
+    // The region updated at step s
+    auto updated = [=](index_type s) {
+        idx b{};
+        idx e = d;
+        for (size_t i = 0; i < N; ++i) {
+            if (shrink_begin[i]) { b[i] += s * lo[i]; }
+            if (shrink_end[i]) { e[i] -= s * hi[i]; }
+        }
+        return std::make_pair(b, e);
+    };
+
+    const auto [fbegin, fend] = updated(k - 1);
+
+    idx fdims{};
+    idx reach{};
+    for (size_t i = 0; i < N; ++i) {
+        runtime_assert(fend[i] > fbegin[i],
+                       "Too many steps in temporal_window_transform");
+        fdims[i] = fend[i] - fbegin[i];
+        reach[i] = k * (lo[i] + hi[i]);
+    }
+
+    const auto tile = choose_tile_size(fdims, sizeof(T), reach, traversal);
+
+    idx        counts{};
+    index_type tile_count = 1;
+    for (size_t i = 0; i < N; ++i) {
+        counts[i] = (fdims[i] + tile[i] - 1) / tile[i];
+        tile_count *= counts[i];
+    }
+
+    for_each_concurrent(policy, size_t(tile_count), [=](size_t t) {
+        // The tile [tbegin, tend) and its ghost zone [ebegin, eend)
+        idx                      tbegin{};
+        idx                      tend{};
+        idx                      ebegin{};
+        idx                      eend{};
+        std::array<size_type, N> eext{};
+        auto                     r = index_type(t);
+        for (size_t i = N; i-- > 0;) {
+            tbegin[i] = fbegin[i] + (r % counts[i]) * tile[i];
+            tend[i]   = std::min(tbegin[i] + tile[i], fend[i]);
+            ebegin[i] = std::max(tbegin[i] - k * lo[i], -lo[i]);
+            eend[i]   = std::min(tend[i] + k * hi[i], d[i] + hi[i]);
+            eext[i]   = size_type(eend[i] - ebegin[i]);
+            r /= counts[i];
+        }
+
+        auto to_local = [=](idx md_idx) {
+            for (size_t i = 0; i < N; ++i) { md_idx[i] -= ebegin[i]; }
+            return md_idx;
+        };
+
+        std::vector<T> a(flat_size(eext));
+        auto           a_span = make_span(a, eext);
+        md_for_each(std::execution::seq, ebegin, eend, [=](idx md_idx) {
+            a_span(to_local(md_idx)) = i_span(md_idx);
+        });
+
+        std::vector<T> b(a);
+        auto           b_span = make_span(b, eext);
+
+        auto cur  = a_span;
+        auto next = b_span;
+        for (index_type s = 0; s < k; ++s) {
+
+            auto [ubegin, uend] = updated(s);
+            idx rbegin{};
+            idx rend{};
+            for (size_t i = 0; i < N; ++i) {
+                const auto ghost = k - 1 - s;
+                rbegin[i] = std::max(tbegin[i] - ghost * lo[i], ubegin[i]);
+                rend[i]   = std::min(tend[i] + ghost * hi[i], uend[i]);
+            }
+
+            jada::window_transform(
+                std::execution::seq,
+                make_subspan(cur, to_local(rbegin), to_local(rend)),
+                make_subspan(next, to_local(rbegin), to_local(rend)),
+                f);
+
+            std::swap(cur, next);
+        }
+
+        md_for_each(std::execution::seq, tbegin, tend, [=](idx md_idx) {
+            o_span(md_idx) = cur(to_local(md_idx));
+        });
+    });
+}
+
+} // namespace detail
+
+/// @brief Applies the input unary window function 'steps' times to the input
+/// span, i.e. computes the result of 'steps' window_transforms where the
+/// output of a step is the input of the next one, and stores the result into
+/// the output span. The padding around the input span needs to cover the
+/// offsets accessed by f and is kept fixed during the steps. The span is
+/// processed in cache-sized tiles advancing all the steps at once, which
+/// replaces 'steps' sweeps over memory with a single one at the cost of
+/// recomputing the ghost zones of the tiles. Executed according to policy (not
+/// necessarily in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param i_span the input span.
+/// @param o_span the output span.
+/// @param f the unary window operation. Example: f = [](auto accessor){return
+/// accessor(1,0) + accessor(-1,0);};
+/// @param steps the number of steps to advance.
+/// @param traversal the tile sizes, zero sizes are chosen automatically.
+template <class ExecutionPolicy,
+          class InputSpan,
+          class OutputSpan,
+          class UnaryWindowFunction,
+          size_t N = InputSpan::rank()>
+static void temporal_window_transform(ExecutionPolicy&&   policy,
+                                      InputSpan           i_span,
+                                      OutputSpan          o_span,
+                                      UnaryWindowFunction f,
+                                      size_t              steps,
+                                      Blocked<N>          traversal = {}) {
+
+    detail::temporal_window_transform(policy,
+                                      i_span,
+                                      o_span,
+                                      f,
+                                      steps,
+                                      std::array<bool, N>{},
+                                      std::array<bool, N>{},
+                                      traversal);
+}
+
+/// @brief Applies the input unary window function 'steps' times to the input
+/// span and stores the result into the output span. Executed in order.
+/// @param i_span the input span.
+/// @param o_span the output span.
+/// @param f the unary window operation.
+/// @param steps the number of steps to advance.
+template <class InputSpan, class OutputSpan, class UnaryWindowFunction>
+static void temporal_window_transform(InputSpan           i_span,
+                                      OutputSpan          o_span,
+                                      UnaryWindowFunction f,
+                                      size_t              steps) {
+
+    temporal_window_transform(std::execution::seq, i_span, o_span, f, steps);
+}
+
+} // namespace jada
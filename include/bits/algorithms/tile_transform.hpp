@@ -90,6 +90,47 @@ static constexpr void tile_transform(ExecutionPolicy&& policy,
     detail::window_transform(policy, i_span, o_span, f, tile);
 }
 
+/// @brief Applies the input unary tile function to all elements of the input
+/// span and stores the result into the output span traversing the spans in
+/// blocks. A tile accessor is one dimensional. Executed according to policy
+/// (not necessarily in order).
+/// @tparam Dir the direction (index) along which the tile is created.
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param i_span the input span.
+/// @param o_span the output span.
+/// @param f the unary tile operation. Example: f = [](auto accessor){return
+/// accessor(0) + accessor(1);};
+/// @param traversal the block sizes, zero sizes are chosen automatically from
+/// the offsets accessed by f.
+template <size_t Dir,
+          class ExecutionPolicy,
+          class InputSpan,
+          class OutputSpan,
+          class UnaryTileFunction,
+          size_t N>
+static constexpr void tile_transform(ExecutionPolicy&& policy,
+                                     InputSpan         i_span,
+                                     OutputSpan        o_span,
+                                     UnaryTileFunction f,
+                                     Blocked<N>        traversal) {
+
+    static_assert(rank(i_span) == N, "Rank mismatch in tile_transform");
+
+    const auto tile = [](auto idx, auto span) {
+        return idxhandle_md_to_oned<Dir>(span, idx);
+    };
+
+    const auto [tmin, tmax] = min_max_offset(f);
+
+    std::array<index_type, N> min{};
+    std::array<index_type, N> max{};
+    min[Dir] = tmin;
+    max[Dir] = tmax;
+
+    detail::window_transform(
+        policy, i_span, o_span, f, tile, min, max, traversal);
+}
+
 /// @brief Applies the input unary tile function to all elements of the input
 /// span and stores the result into the output span. A tile accessor is
 /// one-dimensional. Executed in order.
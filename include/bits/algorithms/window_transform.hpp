@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <execution>
 
+#include "include/bits/algorithms/blocking.hpp"
 #include "include/bits/algorithms/md_for_each.hpp"
 
 namespace jada {
@@ -28,6 +29,37 @@ static constexpr void window_transform(ExecutionPolicy&&  policy,
     md_for_each(policy, all_indices(i_span), func);
 }
 
+template <class ExecutionPolicy,
+          class InputSpan,
+          class OutputSpan,
+          class UnaryIndexFunction,
+          class WindowMaker,
+          size_t N>
+static constexpr void window_transform(ExecutionPolicy&&         policy,
+                                       InputSpan                 i_span,
+                                       OutputSpan                o_span,
+                                       UnaryIndexFunction        f,
+                                       WindowMaker               f2,
+                                       std::array<index_type, N> min,
+                                       std::array<index_type, N> max,
+                                       Blocked<N>                traversal) {
+
+    runtime_assert(dimensions(i_span) == dimensions(o_span),
+                   "Dimension mismatch in shifted_transform()");
+
+    auto func = [=](auto md_idx) { o_span(md_idx) = f(f2(md_idx, i_span)); };
+
+    const auto                dims = dimensions(i_span);
+    std::array<index_type, N> end{};
+    for (size_t i = 0; i < N; ++i) { end[i] = index_type(dims[i]); }
+
+    using element_type = typename InputSpan::element_type;
+    const auto block   = choose_block_size(
+        end, sizeof(element_type), min, max, traversal);
+
+    md_for_each_blocked(policy, std::array<index_type, N>{}, end, block, func);
+}
+
 } // namespace detail
 
 /// @brief Applies the input unary window function to all elements of the input
@@ -55,6 +87,40 @@ static constexpr void window_transform(ExecutionPolicy&&   policy,
     detail::window_transform(policy, i_span, o_span, f, window);
 }
 
+/// @brief Applies the input unary window function to all elements of the input
+/// span and stores the result into the output span traversing the spans in
+/// blocks. A window accessor has the same dimensions as the input spans.
+/// Executed according to policy (not necessarily in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param i_span the input span.
+/// @param o_span the output span.
+/// @param f the unary window operation. Example: f = [](auto accessor){return
+/// accessor(1,0) + accessor(-1,0);};
+/// @param traversal the block sizes, zero sizes are chosen automatically from
+/// the offsets accessed by f.
+template <class ExecutionPolicy,
+          class InputSpan,
+          class OutputSpan,
+          class UnaryWindowFunction,
+          size_t N>
+static constexpr void window_transform(ExecutionPolicy&&   policy,
+                                       InputSpan           i_span,
+                                       OutputSpan          o_span,
+                                       UnaryWindowFunction f,
+                                       Blocked<N>          traversal) {
+
+    static_assert(rank(i_span) == N, "Rank mismatch in window_transform");
+
+    const auto window = [](auto idx, auto span) {
+        return make_subspan(span, idx);
+    };
+
+    const auto [min, max] = md_min_max_offset<N>(f);
+
+    detail::window_transform(
+        policy, i_span, o_span, f, window, min, max, traversal);
+}
+
 /// @brief Applies the input unary window function to all elements of the input
 /// span and stores the result into the output span. A window accessor has the
 /// same dimensions as the input spans. Executed in order.
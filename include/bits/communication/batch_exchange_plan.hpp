@@ -0,0 +1,405 @@
+#pragma once
+
+#include <cstddef>
+#include <execution>
+#include <tuple>
+#include <utility>
+
+#include "exchange_plan.hpp"
+
+namespace jada {
+
+///
+///@brief A precomputed halo exchange of several fields with identical topology,
+/// padding and rank. The fields may have different element types. All the
+/// transfers of all the fields between a pair of processes are packed into a
+/// single message, so that exchanging k fields costs the same number of
+/// messages as exchanging one. Within a message, the slices of each field are
+/// stored in a separate segment aligned to std::max_align_t. The messages are
+/// sent as raw bytes which assumes that all processes share the same data
+/// representation. Transfers between the boxes of the calling process are
+/// copied directly. The blocks given to start() must not be modified nor
+/// destroyed before the exchange has completed. The execution policy given to
+/// start(), wait() and test() is used for packing and unpacking, independent
+/// transfers are processed concurrently under a parallel policy. A plan
+/// destroyed with a running exchange completes it without throwing.
+///
+///@tparam N number of spatial dimensions
+///@tparam Ts the element types of the exchanged fields
+///
+template <size_t N, class... Ts> class BatchExchangePlan {
+
+    static_assert(sizeof...(Ts) > 0, "At least one field is required");
+    static_assert((std::is_trivially_copyable_v<Ts> && ...),
+                  "Only trivially copyable fields can be exchanged");
+
+public:
+    static constexpr size_t field_count = sizeof...(Ts);
+
+    BatchExchangePlan(const Topology<N>&        topology,
+                      std::array<index_type, N> begin_padding,
+                      std::array<index_type, N> end_padding,
+                      int                       rank,
+                      MPI_Comm                  comm = MPI_COMM_WORLD)
+        : m_comm(comm)
+        , m_sends(detail::send_transfers(
+              topology, begin_padding, end_padding, rank))
+        , m_recvs(detail::receive_transfers(
+              topology, begin_padding, end_padding, rank))
+        , m_locals(detail::local_transfers(
+              topology, begin_padding, end_padding, rank))
+        , m_send_messages(detail::group_by_peer(
+              m_sends, [](const auto& t) { return t.info.receiver_rank; }))
+        , m_recv_messages(detail::group_by_peer(
+              m_recvs, [](const auto& t) { return t.info.sender_rank; })) {
+
+        for (const auto& box : topology.get_boxes(rank)) {
+            m_padded_dims.push_back(extent_to_array(
+                add_padding(box.get_extent(), begin_padding, end_padding)));
+        }
+
+        m_send_message_of = message_indices(m_send_messages);
+        m_recv_message_of = message_indices(m_recv_messages);
+        m_send_offsets    = byte_offsets(m_send_messages);
+        m_recv_offsets    = byte_offsets(m_recv_messages);
+        m_send_buffer.resize(m_send_offsets.back());
+        m_recv_buffer.resize(m_recv_offsets.back());
+
+        for (size_t i = 0; i < m_recv_messages.size(); ++i) {
+            m_requests.push_back(mpi::recv_init(
+                m_recv_buffer.data() + m_recv_offsets[i],
+                static_cast<int>(message_bytes(m_recv_messages[i].count)),
+                MPI_BYTE,
+                m_recv_messages[i].peer,
+                message_tag,
+                m_comm));
+        }
+
+        for (size_t i = 0; i < m_send_messages.size(); ++i) {
+            m_requests.push_back(mpi::send_init(
+                m_send_buffer.data() + m_send_offsets[i],
+                static_cast<int>(message_bytes(m_send_messages[i].count)),
+                MPI_BYTE,
+                m_send_messages[i].peer,
+                message_tag,
+                m_comm));
+        }
+    }
+
+    BatchExchangePlan(const BatchExchangePlan&)            = delete;
+    BatchExchangePlan& operator=(const BatchExchangePlan&) = delete;
+
+    BatchExchangePlan(BatchExchangePlan&& other) noexcept { swap(other); }
+
+    BatchExchangePlan& operator=(BatchExchangePlan&& other) noexcept {
+        if (this != &other) {
+            BatchExchangePlan tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~BatchExchangePlan() noexcept {
+        if (mpi::finalized()) { return; }
+
+        // Errors can not be reported from the destructor, so a running
+        // exchange is completed without the checks of wait(), its unpacking
+        // is skipped if it fails and the requests are freed unchecked
+        if (m_active) {
+            MPI_Waitall(static_cast<int>(m_requests.size()),
+                        m_requests.data(),
+                        MPI_STATUSES_IGNORE);
+            try {
+                finish(std::execution::seq);
+            } catch (...) {}
+        }
+        for (auto& r : m_requests) { MPI_Request_free(&r); }
+    }
+
+    ///
+    ///@brief Packs the sent slices of all the fields, starts all the messages
+    /// of the exchange and copies the transfers within the process while the
+    /// messages are in flight. The copies are executed according to policy.
+    ///
+    ///@param policy the execution policy to use
+    ///@param blocks the padded data of each local box for each field,
+    /// blocks[i] corresponds to topology.get_boxes(rank)[i]
+    ///
+    template <class ExecutionPolicy>
+    void start(ExecutionPolicy&& policy, std::vector<std::span<Ts>>... blocks) {
+
+        runtime_assert(!m_active, "Exchange already in progress");
+        runtime_assert(((blocks.size() == m_padded_dims.size()) && ...),
+                       "Block count mismatch in BatchExchangePlan");
+
+        m_blocks = std::make_tuple(std::move(blocks)...);
+
+        {
+            ScopedTimer timer(Phase::Pack);
+            for_each_field([&]<size_t I>() { pack<I>(policy); });
+        }
+
+        {
+            ScopedTimer timer(Phase::Post);
+            mpi::start_all(m_requests);
+            m_active = true;
+        }
+
+        if constexpr (profiling_enabled) {
+            for (const auto& m : m_send_messages) {
+                record_sent(m.peer, message_bytes(m.count));
+            }
+        }
+
+        ScopedTimer timer(Phase::LocalCopy);
+        for_each_field([&]<size_t I>() {
+            detail::for_each_concurrent(
+                policy, m_locals.size(), [&](size_t i) {
+                    detail::copy_local(policy,
+                                       m_locals[i],
+                                       std::get<I>(m_blocks),
+                                       m_padded_dims);
+                });
+        });
+    }
+
+    ///
+    ///@brief Packs the sent slices of all the fields and starts all the
+    /// messages of the exchange. Executed in order.
+    ///
+    ///@param blocks the padded data of each local box for each field,
+    /// blocks[i] corresponds to topology.get_boxes(rank)[i]
+    ///
+    void start(std::vector<std::span<Ts>>... blocks) {
+        start(std::execution::seq, std::move(blocks)...);
+    }
+
+    ///
+    ///@brief Blocks until all the messages of the exchange have completed and
+    /// copies the received data to the padding of the blocks given to start().
+    /// The copies are executed according to policy.
+    ///
+    ///@param policy the execution policy to use
+    ///
+    template <class ExecutionPolicy> void wait(ExecutionPolicy&& policy) {
+        if (!m_active) { return; }
+        {
+            ScopedTimer timer(Phase::Wait);
+            mpi::wait_all(m_requests);
+        }
+        finish(policy);
+    }
+
+    ///
+    ///@brief Blocks until all the messages of the exchange have completed and
+    /// copies the received data to the padding of the blocks given to start().
+    /// Executed in order.
+    ///
+    void wait() { wait(std::execution::seq); }
+
+    ///
+    ///@brief Checks without blocking if all the messages of the exchange have
+    /// completed. If so, copies the received data to the padding of the blocks
+    /// given to start(). The copies are executed according to policy.
+    ///
+    ///@param policy the execution policy to use
+    ///@return true if the exchange has completed, false otherwise
+    ///
+    template <class ExecutionPolicy> bool test(ExecutionPolicy&& policy) {
+        if (!m_active) { return true; }
+        {
+            ScopedTimer timer(Phase::Wait);
+            if (!mpi::test_all(m_requests)) { return false; }
+        }
+        finish(policy);
+        return true;
+    }
+
+    ///
+    ///@brief Checks without blocking if all the messages of the exchange have
+    /// completed. If so, copies the received data to the padding of the blocks
+    /// given to start(). Executed in order.
+    ///
+    ///@return true if the exchange has completed, false otherwise
+    ///
+    bool test() { return test(std::execution::seq); }
+
+    ///
+    ///@brief Checks if the last started exchange has been completed.
+    ///
+    ///@return true if no exchange is in progress, false otherwise
+    ///
+    bool is_complete() const { return !m_active; }
+
+    ///
+    ///@brief Returns the number of messages (sends and receives) of one
+    /// exchange of all the fields.
+    ///
+    ///@return size_t the number of messages
+    ///
+    size_t message_count() const {
+        return m_send_messages.size() + m_recv_messages.size();
+    }
+
+    const auto& send_messages() const { return m_send_messages; }
+    const auto& receive_messages() const { return m_recv_messages; }
+
+private:
+    // All the transfers between a pair of processes are in a single message
+    static constexpr int message_tag = 0;
+
+    static constexpr size_t alignment = alignof(std::max_align_t);
+
+    using fields = std::tuple<Ts...>;
+
+    MPI_Comm                                  m_comm   = MPI_COMM_WORLD;
+    bool                                      m_active = false;
+    std::vector<PlannedTransfer<N>>           m_sends;
+    std::vector<PlannedTransfer<N>>           m_recvs;
+    std::vector<LocalTransfer<N>>             m_locals;
+    std::vector<PlannedMessage>               m_send_messages;
+    std::vector<PlannedMessage>               m_recv_messages;
+    std::vector<size_t>                       m_send_offsets;
+    std::vector<size_t>                       m_recv_offsets;
+    std::vector<size_t>                       m_send_message_of;
+    std::vector<size_t>                       m_recv_message_of;
+    std::vector<std::byte>                    m_send_buffer;
+    std::vector<std::byte>                    m_recv_buffer;
+    std::vector<std::array<size_type, N>>     m_padded_dims;
+    std::vector<MPI_Request>                  m_requests;
+    std::tuple<std::vector<std::span<Ts>>...> m_blocks;
+
+    static constexpr size_t align_up(size_t bytes) {
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+
+    ///
+    ///@brief Returns the byte offset of the segment of field I in a message
+    /// of 'count' elements per field. With I = field_count, returns the size
+    /// of the message.
+    ///
+    template <size_t I> static size_t segment_offset(size_t count) {
+        constexpr std::array<size_t, field_count> sizes{sizeof(Ts)...};
+        size_t                                    ret = 0;
+        for (size_t i = 0; i < I; ++i) { ret += align_up(count * sizes[i]); }
+        return ret;
+    }
+
+    static size_t message_bytes(size_t count) {
+        return segment_offset<field_count>(count);
+    }
+
+    ///
+    ///@brief Returns the byte offsets of the input messages in a packed buffer
+    /// with the total size of the buffer as the last element.
+    ///
+    static std::vector<size_t>
+    byte_offsets(const std::vector<PlannedMessage>& messages) {
+        std::vector<size_t> ret{0};
+        for (const auto& m : messages) {
+            ret.push_back(ret.back() + message_bytes(m.count));
+        }
+        return ret;
+    }
+
+    ///
+    ///@brief Returns the index of the message of each transfer.
+    ///
+    static std::vector<size_t>
+    message_indices(const std::vector<PlannedMessage>& messages) {
+        std::vector<size_t> ret;
+        for (size_t i = 0; i < messages.size(); ++i) {
+            ret.insert(ret.end(), messages[i].last - messages[i].first, i);
+        }
+        return ret;
+    }
+
+    template <class F> static void for_each_field(F f) {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (f.template operator()<I>(), ...);
+        }(std::index_sequence_for<Ts...>{});
+    }
+
+    ///
+    ///@brief Returns a view of the slice of transfer t in the segment of
+    /// field I in a packed buffer.
+    ///
+    template <size_t I>
+    static auto packed_slice(std::byte*                buffer,
+                             size_t                    message_offset,
+                             const PlannedMessage&     m,
+                             const PlannedTransfer<N>& t) {
+        using T   = std::tuple_element_t<I, fields>;
+        auto ptr  = buffer + message_offset + segment_offset<I>(m.count);
+        auto data = reinterpret_cast<T*>(ptr) + (t.offset - m.offset);
+        return span<T, N>(data, make_extent(t.info.extent));
+    }
+
+    template <size_t I, class ExecutionPolicy>
+    void pack(ExecutionPolicy&& policy) {
+
+        detail::for_each_concurrent(policy, m_sends.size(), [&](size_t j) {
+            const auto  i    = m_send_message_of[j];
+            const auto& t    = m_sends[j];
+            auto        from = detail::block_slice(std::get<I>(m_blocks)[t.block],
+                                            m_padded_dims[t.block],
+                                            t.info.sender_begin,
+                                            t.info.extent);
+            auto        to   = packed_slice<I>(
+                m_send_buffer.data(), m_send_offsets[i], m_send_messages[i], t);
+            transform(policy, from, to, [](auto val) { return val; });
+        });
+    }
+
+    template <size_t I, class ExecutionPolicy>
+    void unpack(ExecutionPolicy&& policy) {
+
+        detail::for_each_concurrent(policy, m_recvs.size(), [&](size_t j) {
+            const auto  i    = m_recv_message_of[j];
+            const auto& t    = m_recvs[j];
+            auto        from = packed_slice<I>(
+                m_recv_buffer.data(), m_recv_offsets[i], m_recv_messages[i], t);
+            auto to = detail::block_slice(std::get<I>(m_blocks)[t.block],
+                                          m_padded_dims[t.block],
+                                          t.info.receiver_begin,
+                                          t.info.extent);
+            transform(policy, from, to, [](auto val) { return val; });
+        });
+    }
+
+    template <class ExecutionPolicy> void finish(ExecutionPolicy&& policy) {
+
+        if constexpr (profiling_enabled) {
+            for (const auto& m : m_recv_messages) {
+                record_received(m.peer, message_bytes(m.count));
+            }
+        }
+
+        {
+            ScopedTimer timer(Phase::Unpack);
+            for_each_field([&]<size_t I>() { unpack<I>(policy); });
+        }
+        m_active = false;
+    }
+
+    void swap(BatchExchangePlan& other) noexcept {
+        std::swap(m_comm, other.m_comm);
+        std::swap(m_active, other.m_active);
+        std::swap(m_sends, other.m_sends);
+        std::swap(m_recvs, other.m_recvs);
+        std::swap(m_locals, other.m_locals);
+        std::swap(m_send_messages, other.m_send_messages);
+        std::swap(m_recv_messages, other.m_recv_messages);
+        std::swap(m_send_offsets, other.m_send_offsets);
+        std::swap(m_recv_offsets, other.m_recv_offsets);
+        std::swap(m_send_message_of, other.m_send_message_of);
+        std::swap(m_recv_message_of, other.m_recv_message_of);
+        std::swap(m_send_buffer, other.m_send_buffer);
+        std::swap(m_recv_buffer, other.m_recv_buffer);
+        std::swap(m_padded_dims, other.m_padded_dims);
+        std::swap(m_requests, other.m_requests);
+        std::swap(m_blocks, other.m_blocks);
+    }
+};
+
+} // namespace jada
@@ -20,8 +20,21 @@ std::ostream& operator<<(std::ostream& os, const Channel<L, TT>& v) {
 
 
 
-template <class Data, size_t N>
-auto make_sendable_slice(const Data&               data,
+///
+///@brief Copies the slice of the sender box described by 'info' to a new
+/// contiguous buffer. The copy is executed according to policy.
+///
+///@param policy the execution policy to use
+///@param data the padded data of the sender box
+///@param sender the sender box
+///@param begin_padding padding at the beginning of the sender box
+///@param end_padding padding at the end of the sender box
+///@param info the transfer to pack
+///@return std::vector<T> the packed slice
+///
+template <class ExecutionPolicy, class Data, size_t N>
+auto make_sendable_slice(ExecutionPolicy&&         policy,
+                         const Data&               data,
                          const BoxRankPair<N>&     sender,
                          std::array<index_type, N> begin_padding,
                          std::array<index_type, N> end_padding,
@@ -37,11 +50,21 @@ auto make_sendable_slice(const Data&               data,
     auto slice = make_subspan(
         big_span, info.sender_begin, get_end(info.sender_begin, info.extent));
 
-    transform(slice, buffer_span, [](auto val) { return val; });
+    transform(policy, slice, buffer_span, [](auto val) { return val; });
 
     return buffer;
 }
 
+template <class Data, size_t N>
+auto make_sendable_slice(const Data&               data,
+                         const BoxRankPair<N>&     sender,
+                         std::array<index_type, N> begin_padding,
+                         std::array<index_type, N> end_padding,
+                         const TransferInfo<N>&    info) {
+    return make_sendable_slice(
+        std::execution::seq, data, sender, begin_padding, end_padding, info);
+}
+
 template <size_t N, class T>
 void put(Channel<N, T>&         channel,
          const TransferInfo<N>& tag,
@@ -0,0 +1,719 @@
+#pragma once
+
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "distributed_array.hpp"
+#include "distributed_io.hpp"
+#include "mpi_functions.hpp"
+
+namespace jada {
+
+///
+///@brief The kind of the element type stored in a checkpoint. Together with
+/// the element size it identifies the element type independently of the
+/// compiler which wrote the file.
+///
+enum class CheckpointElementKind : uint64_t {
+    other            = 0, // any other trivially copyable type
+    boolean          = 1,
+    signed_integer   = 2,
+    unsigned_integer = 3,
+    floating_point   = 4,
+    complex          = 5
+};
+
+///
+///@brief The metadata of a checkpoint file written by write_checkpoint. The
+/// file begins with a header holding the topology, the padding and the element
+/// type of the array followed by the unpadded data of each box of the topology
+/// in row-major order at the byte offsets listed in 'offsets'.
+///
+///@tparam N the rank of the checkpointed array
+///
+template <size_t N> struct CheckpointInfo {
+
+    static constexpr char magic[8] = {'J', 'A', 'D', 'A', 'C', 'K', 'P', 'T'};
+    static constexpr uint64_t version = 2;
+
+    Topology<N>               topology;
+    std::array<index_type, N> begin_padding;
+    std::array<index_type, N> end_padding;
+    uint64_t                  element_size;
+    CheckpointElementKind     element_kind;
+    std::vector<uint64_t>     offsets; // byte offsets of the box data
+
+    ///
+    ///@brief Returns the total size of the checkpoint file in bytes.
+    ///
+    uint64_t file_size() const {
+        const auto& boxes = topology.get_boxes();
+        if (boxes.empty()) { return header_size(); }
+        return offsets.back() + boxes.back().box.size() * element_size;
+    }
+
+    ///
+    ///@brief Returns the size of the header in bytes, i.e. the offset of the
+    /// data of the first box.
+    ///
+    uint64_t header_size() const {
+        return offsets.empty() ? 0 : offsets.front();
+    }
+};
+
+namespace detail {
+
+///
+///@brief Size of the fixed part of the checkpoint header which stores the
+/// total header size.
+///
+static constexpr size_t checkpoint_prefix_size = 8 + 6 * sizeof(uint64_t);
+
+///
+///@brief Byte offset of the total header size in the checkpoint header.
+///
+static constexpr size_t checkpoint_size_offset = 8 + 4 * sizeof(uint64_t);
+
+///
+///@brief Size of the record of a single box in the checkpoint header: the
+/// rank, the begin and end indices and the byte offset of the data.
+///
+template <size_t N>
+static constexpr size_t checkpoint_box_record_size =
+    (2 * N + 2) * sizeof(uint64_t);
+
+///
+///@brief Returns the size of the header of a checkpoint of rank N with
+/// 'box_count' boxes: the fixed prefix, the domain, the periods, the paddings
+/// and the box records.
+///
+template <size_t N>
+static constexpr uint64_t checkpoint_header_bytes(uint64_t box_count) {
+    return checkpoint_prefix_size + 4 * N * sizeof(int64_t) +
+           N * sizeof(uint8_t) + box_count * checkpoint_box_record_size<N>;
+}
+
+///
+///@brief Alignment of the box data in checkpoint files in bytes.
+///
+static constexpr uint64_t checkpoint_alignment = 64;
+
+///
+///@brief Appends the byte representations of trivially copyable values to a
+/// buffer.
+///
+struct ByteWriter {
+    std::vector<std::byte> bytes;
+
+    template <class U> void put(const U& v) {
+        static_assert(std::is_trivially_copyable_v<U>,
+                      "Only trivially copyable types can be written");
+        const auto old = bytes.size();
+        bytes.resize(old + sizeof(U));
+        std::memcpy(bytes.data() + old, &v, sizeof(U));
+    }
+
+    template <class U, size_t L> void put(const std::array<U, L>& v) {
+        for (const auto& e : v) { put(e); }
+    }
+};
+
+///
+///@brief Reads the values written by ByteWriter back in the same order. The
+/// bytes come from a file, so reading past the end throws.
+///
+struct ByteReader {
+    const std::vector<std::byte>& bytes;
+    size_t                        pos = 0;
+
+    template <class U> U get() {
+        if (bytes.size() - pos < sizeof(U)) {
+            throw std::runtime_error("Truncated checkpoint header");
+        }
+        U ret;
+        std::memcpy(&ret, bytes.data() + pos, sizeof(U));
+        pos += sizeof(U);
+        return ret;
+    }
+
+    index_type get_index() {
+        const auto v = get<int64_t>();
+        if (v < std::numeric_limits<index_type>::min() ||
+            v > std::numeric_limits<index_type>::max()) {
+            throw std::runtime_error("Invalid index in checkpoint header");
+        }
+        return index_type(v);
+    }
+
+    size_t remaining() const { return bytes.size() - pos; }
+
+    template <class U, size_t L> std::array<U, L> get_array() {
+        std::array<U, L> ret{};
+        for (auto& e : ret) { e = get<U>(); }
+        return ret;
+    }
+};
+
+///
+///@brief Checks if T is a std::complex.
+///
+template <class T> struct is_complex : std::false_type {};
+template <class T> struct is_complex<std::complex<T>> : std::true_type {};
+
+///
+///@brief Returns the kind of the element type stored in checkpoints.
+///
+template <class T>
+static constexpr CheckpointElementKind checkpoint_element_kind() {
+    using K = CheckpointElementKind;
+    if constexpr (std::is_same_v<T, bool>) { return K::boolean; }
+    if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        return K::signed_integer;
+    }
+    if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T>) {
+        return K::unsigned_integer;
+    }
+    if constexpr (std::is_floating_point_v<T>) { return K::floating_point; }
+    if constexpr (is_complex<T>::value) { return K::complex; }
+    return K::other;
+}
+
+///
+///@brief Serializes the checkpoint header.
+///
+template <size_t N>
+static inline std::vector<std::byte>
+serialize_header(const CheckpointInfo<N>& info) {
+
+    const auto& topo  = info.topology;
+    const auto& boxes = topo.get_boxes();
+
+    ByteWriter w;
+    w.put(CheckpointInfo<N>::magic);
+    w.put(CheckpointInfo<N>::version);
+    w.put(uint64_t(N));
+    w.put(info.element_size);
+    w.put(uint64_t(boxes.size()));
+    w.put(uint64_t(0)); // header size, filled below
+    w.put(info.element_kind);
+
+    for (auto e : topo.get_domain().begin) { w.put(int64_t(e)); }
+    for (auto e : topo.get_domain().end) { w.put(int64_t(e)); }
+    for (auto e : topo.get_periods()) { w.put(uint8_t(e)); }
+    for (auto e : info.begin_padding) { w.put(int64_t(e)); }
+    for (auto e : info.end_padding) { w.put(int64_t(e)); }
+
+    for (size_t j = 0; j < boxes.size(); ++j) {
+        w.put(int64_t(boxes[j].rank));
+        for (auto e : boxes[j].box.begin) { w.put(int64_t(e)); }
+        for (auto e : boxes[j].box.end) { w.put(int64_t(e)); }
+        w.put(info.offsets[j]);
+    }
+
+    const uint64_t size = w.bytes.size();
+    runtime_assert(size == checkpoint_header_bytes<N>(boxes.size()),
+                   "Checkpoint header size mismatch");
+    std::memcpy(w.bytes.data() + checkpoint_size_offset, &size, sizeof(size));
+    return w.bytes;
+}
+
+///
+///@brief Creates the checkpoint metadata of the array.
+///
+template <size_t N, class T, class A>
+static inline CheckpointInfo<N>
+make_checkpoint_info(const DistributedArray<N, T, A>& array) {
+
+    CheckpointInfo<N> info{array.topology(),
+                           array.get_begin_padding(),
+                           array.get_end_padding(),
+                           sizeof(T),
+                           checkpoint_element_kind<T>(),
+                           {}};
+
+    const auto&    boxes  = info.topology.get_boxes();
+    const uint64_t header = checkpoint_header_bytes<N>(boxes.size());
+
+    auto align = [](uint64_t v) {
+        return (v + checkpoint_alignment - 1) / checkpoint_alignment *
+               checkpoint_alignment;
+    };
+
+    uint64_t offset = align(header);
+    for (const auto& pair : boxes) {
+        info.offsets.push_back(offset);
+        offset = align(offset + pair.box.size() * sizeof(T));
+    }
+    return info;
+}
+
+///
+///@brief Checks the fixed prefix of a checkpoint header and returns the total
+/// size of the header. The prefix is checked before the size stored in it is
+/// trusted. Throws std::runtime_error if the file is not a checkpoint of rank N
+/// written with the current version.
+///
+///@param prefix the first bytes of the file
+///@param available the number of bytes in prefix
+///@param file_size the size of the file in bytes
+///@return uint64_t the size of the header in bytes
+///
+template <size_t N>
+static inline uint64_t checkpoint_header_size(const std::byte* prefix,
+                                              uint64_t         available,
+                                              uint64_t         file_size) {
+
+    const auto& magic = CheckpointInfo<N>::magic;
+    if (available < checkpoint_prefix_size ||
+        std::memcmp(prefix, magic, sizeof(magic)) != 0) {
+        throw std::runtime_error("Not a checkpoint file");
+    }
+
+    auto field = [=](size_t offset) {
+        uint64_t v;
+        std::memcpy(&v, prefix + offset, sizeof(v));
+        return v;
+    };
+
+    if (field(8) != CheckpointInfo<N>::version) {
+        throw std::runtime_error("Unsupported checkpoint version");
+    }
+    if (field(16) != N) {
+        throw std::runtime_error("Rank mismatch in checkpoint");
+    }
+
+    const uint64_t size = field(checkpoint_size_offset);
+    if (size < checkpoint_prefix_size || size > file_size) {
+        throw std::runtime_error("Truncated checkpoint header");
+    }
+    return size;
+}
+
+///
+///@brief Deserializes the checkpoint header and checks that it describes a
+/// valid topology whose box data lies within the file. Throws
+/// std::runtime_error otherwise.
+///
+///@param bytes the header
+///@param file_size the size of the file in bytes
+///@return CheckpointInfo<N> the metadata of the checkpoint
+///
+template <size_t N>
+static inline CheckpointInfo<N>
+deserialize_header(const std::vector<std::byte>& bytes, uint64_t file_size) {
+
+    checkpoint_header_size<N>(bytes.data(), bytes.size(), file_size);
+
+    // Skip the magic, the version and the rank checked above
+    ByteReader r{bytes, 8 + 2 * sizeof(uint64_t)};
+
+    const auto element_size = r.get<uint64_t>();
+    const auto box_count    = r.get<uint64_t>();
+    r.get<uint64_t>(); // header size
+    const auto element_kind = r.get<CheckpointElementKind>();
+
+    if (element_size == 0) {
+        throw std::runtime_error("Invalid element size in checkpoint");
+    }
+
+    std::array<index_type, N> begin{};
+    std::array<index_type, N> end{};
+    std::array<bool, N>       periodic{};
+    std::array<index_type, N> bpad{};
+    std::array<index_type, N> epad{};
+    for (auto& e : begin) { e = r.get_index(); }
+    for (auto& e : end) { e = r.get_index(); }
+    for (auto& e : periodic) { e = r.get<uint8_t>() != 0; }
+    for (auto& e : bpad) { e = r.get_index(); }
+    for (auto& e : epad) { e = r.get_index(); }
+
+    // Check the count before allocating for the boxes
+    if (box_count > r.remaining() / checkpoint_box_record_size<N>) {
+        throw std::runtime_error("Truncated checkpoint header");
+    }
+
+    for (size_t i = 0; i < N; ++i) {
+        if (begin[i] > end[i] || bpad[i] < 0 || epad[i] < 0) {
+            throw std::runtime_error("Invalid domain in checkpoint");
+        }
+    }
+
+    std::vector<BoxRankPair<N>> boxes(box_count);
+    std::vector<uint64_t>       offsets(box_count);
+    for (size_t j = 0; j < box_count; ++j) {
+        const auto rank = r.get<int64_t>();
+        if (rank < 0 || rank > std::numeric_limits<int>::max()) {
+            throw std::runtime_error("Invalid rank in checkpoint");
+        }
+        boxes[j].rank = int(rank);
+        for (auto& e : boxes[j].box.begin) { e = r.get_index(); }
+        for (auto& e : boxes[j].box.end) { e = r.get_index(); }
+        offsets[j] = r.get<uint64_t>();
+
+        const auto& box = boxes[j].box;
+        for (size_t i = 0; i < N; ++i) {
+            if (box.begin[i] < begin[i] || box.end[i] > end[i] ||
+                box.begin[i] > box.end[i]) {
+                throw std::runtime_error("Invalid box in checkpoint");
+            }
+        }
+
+        // The data of the box has to fit between the header and the file end
+        if (offsets[j] < bytes.size() || offsets[j] > file_size) {
+            throw std::runtime_error("Invalid box offset in checkpoint");
+        }
+        uint64_t       cells     = 1;
+        const uint64_t max_cells = (file_size - offsets[j]) / element_size;
+        for (size_t i = 0; i < N; ++i) {
+            const auto d = uint64_t(box.end[i] - box.begin[i]);
+            if (d != 0 && cells > max_cells / d) {
+                throw std::runtime_error("Truncated checkpoint data");
+            }
+            cells *= d;
+        }
+        if (cells > max_cells) {
+            throw std::runtime_error("Truncated checkpoint data");
+        }
+    }
+
+    CheckpointInfo<N> info{Topology<N>(Box<N>(begin, end), boxes, periodic),
+                           bpad,
+                           epad,
+                           element_size,
+                           element_kind,
+                           offsets};
+
+    if (!info.topology.is_valid()) {
+        throw std::runtime_error("Invalid topology in checkpoint");
+    }
+    return info;
+}
+
+///
+///@brief Reads the header of the checkpoint file on process 0 and broadcasts
+/// it to the others. All processes check the same bytes, so they all throw
+/// std::runtime_error if the file is not a valid checkpoint. Collective over
+/// comm.
+///
+template <size_t N>
+static inline CheckpointInfo<N> read_checkpoint_info(const std::string& filename,
+                                                     MPI_Comm comm) {
+
+    const bool root = mpi::get_rank(comm) == 0;
+    auto       fh   = mpi::file_open(comm, filename, MPI_MODE_RDONLY);
+
+    std::vector<std::byte> bytes(checkpoint_prefix_size);
+    uint64_t               file_size = 0;
+    if (root) {
+        file_size = uint64_t(mpi::file_get_size(fh));
+        mpi::file_read_at(fh,
+                          0,
+                          bytes.data(),
+                          int(std::min(uint64_t(bytes.size()), file_size)),
+                          MPI_BYTE);
+    }
+    mpi::broadcast(&file_size, 1, mpi::MakeDatatype<uint64_t>{}(), 0, comm);
+    mpi::broadcast(bytes.data(), int(bytes.size()), MPI_BYTE, 0, comm);
+
+    uint64_t size = 0;
+    try {
+        size = checkpoint_header_size<N>(bytes.data(), bytes.size(), file_size);
+    } catch (...) {
+        mpi::file_close(fh);
+        throw;
+    }
+
+    bytes.resize(size);
+    if (root) {
+        mpi::file_read_at(fh, 0, bytes.data(), int(bytes.size()), MPI_BYTE);
+    }
+    mpi::broadcast(bytes.data(), int(bytes.size()), MPI_BYTE, 0, comm);
+    mpi::file_close(fh);
+
+    return deserialize_header<N>(bytes, file_size);
+}
+
+} // namespace detail
+
+///
+///@brief Collectively writes the array to a checkpoint file. Process 0 writes
+/// the header holding the topology, the padding and the element type, and
+/// each process writes the unpadded data of its own boxes in place with
+/// MPI-IO collective writes. The padding is not stored.
+///
+///@param array the array to checkpoint
+///@param filename the name of the file
+///@param comm the communicator of the processes
+///
+template <size_t N, class T, class A>
+void write_checkpoint(const DistributedArray<N, T, A>& array,
+                      const std::string&               filename,
+                      MPI_Comm                         comm = MPI_COMM_WORLD) {
+
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable elements can be checkpointed");
+
+    const auto info   = detail::make_checkpoint_info(array);
+    const auto etype  = mpi::MakeDatatype<T>{}();
+    const auto& boxes = array.get_local_boxes();
+    const auto& blocks = array.get_local_data();
+
+    // Global indices of the local boxes
+    std::vector<size_t> global;
+    const auto&         all = array.topology().get_boxes();
+    for (size_t j = 0; j < all.size(); ++j) {
+        if (all[j].rank == array.get_rank()) { global.push_back(j); }
+    }
+
+    auto fh =
+        mpi::file_open(comm, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY);
+    mpi::file_set_size(fh, MPI_Offset(info.file_size()));
+
+    if (mpi::get_rank(comm) == 0) {
+        const auto header = detail::serialize_header(info);
+        mpi::file_write_at(fh, 0, header.data(), int(header.size()), MPI_BYTE);
+    }
+
+    const size_t rounds = mpi::all_reduce(boxes.size(), Maximum{}, comm);
+
+    for (size_t i = 0; i < rounds; ++i) {
+        if (i < boxes.size() && boxes[i].box.size() > 0) {
+            auto mtype = detail::block_datatype(array, i, boxes[i].box);
+            mpi::file_set_view(
+                fh, MPI_Offset(info.offsets[global[i]]), etype, etype);
+            mpi::file_write_all(fh, blocks[i].data(), 1, mtype);
+            mpi::type_free(mtype);
+        } else {
+            mpi::file_set_view(fh, 0, etype, etype);
+            mpi::file_write_all(fh, nullptr, 0, etype);
+        }
+    }
+
+    mpi::file_close(fh);
+}
+
+///
+///@brief Collectively reads the metadata of a checkpoint file. Throws
+/// std::runtime_error if the file is not a valid checkpoint of rank N.
+///
+///@param filename the name of the file
+///@param comm the communicator of the processes
+///@return CheckpointInfo<N> the metadata of the checkpoint
+///
+template <size_t N>
+CheckpointInfo<N> read_checkpoint_info(const std::string& filename,
+                                       MPI_Comm comm = MPI_COMM_WORLD) {
+    return detail::read_checkpoint_info<N>(filename, comm);
+}
+
+///
+///@brief Collectively restarts an array from a checkpoint file using a
+/// possibly different topology and padding than the one which was written,
+/// e.g. a decomposition for a different number of processes. Each process
+/// reads only the intersections of its boxes with the stored boxes through
+/// subarray file views, so no process reads the whole domain. The padding of
+/// the returned array is set to T{}. Throws std::runtime_error if the file is
+/// not a valid checkpoint, or if its element type or domain do not match.
+///
+///@param filename the name of the file
+///@param topology the topology of the returned array, its domain has to equal
+/// the stored domain
+///@param rank the rank of the calling process in the topology
+///@param begin_padding the begin padding of the returned array
+///@param end_padding the end padding of the returned array
+///@param comm the communicator of the processes
+///@return DistributedArray<N, T, A> the restarted array
+///
+template <size_t N, class T, class A = AlignedAllocator<T>>
+DistributedArray<N, T, A>
+read_checkpoint(const std::string&        filename,
+                const Topology<N>&        topology,
+                int                       rank,
+                std::array<index_type, N> begin_padding,
+                std::array<index_type, N> end_padding,
+                MPI_Comm                  comm = MPI_COMM_WORLD) {
+
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable elements can be checkpointed");
+
+    const auto info = detail::read_checkpoint_info<N>(filename, comm);
+
+    if (info.element_size != sizeof(T) ||
+        info.element_kind != detail::checkpoint_element_kind<T>()) {
+        throw std::runtime_error("Element type mismatch in read_checkpoint");
+    }
+    if (info.topology.get_domain() != topology.get_domain()) {
+        throw std::runtime_error("Domain mismatch in read_checkpoint");
+    }
+
+    DistributedArray<N, T, A> ret(rank, topology, begin_padding, end_padding);
+
+    struct Piece {
+        size_t block;  // local block of ret
+        size_t stored; // box in the file
+        Box<N> region; // global intersection
+    };
+
+    std::vector<Piece> pieces;
+    const auto&        local  = ret.get_local_boxes();
+    const auto&        stored = info.topology.get_boxes();
+    for (size_t i = 0; i < local.size(); ++i) {
+        for (size_t j = 0; j < stored.size(); ++j) {
+            if (have_overlap(local[i].box, stored[j].box)) {
+                pieces.push_back(
+                    {i, j, intersection(local[i].box, stored[j].box)});
+            }
+        }
+    }
+
+    auto         fh     = mpi::file_open(comm, filename, MPI_MODE_RDONLY);
+    const auto   etype  = mpi::MakeDatatype<T>{}();
+    const auto&  blocks = ret.get_local_data();
+    const size_t rounds = mpi::all_reduce(pieces.size(), Maximum{}, comm);
+
+    for (size_t i = 0; i < rounds; ++i) {
+        if (i < pieces.size()) {
+            const auto& p     = pieces[i];
+            auto        ftype = detail::domain_datatype<T>(
+                stored[p.stored].box, p.region);
+            auto mtype = detail::block_datatype(ret, p.block, p.region);
+            mpi::file_set_view(
+                fh, MPI_Offset(info.offsets[p.stored]), etype, ftype);
+            mpi::file_read_all(fh, blocks[p.block].data(), 1, mtype);
+            mpi::type_free(mtype);
+            mpi::type_free(ftype);
+        } else {
+            mpi::file_set_view(fh, 0, etype, etype);
+            mpi::file_read_all(fh, nullptr, 0, etype);
+        }
+    }
+
+    mpi::file_close(fh);
+    return ret;
+}
+
+///
+///@brief Collectively restarts an array from a checkpoint file with the stored
+/// topology and padding. The number of processes has to match the stored
+/// topology.
+///
+///@param filename the name of the file
+///@param rank the rank of the calling process in the stored topology
+///@param comm the communicator of the processes
+///@return DistributedArray<N, T, A> the restarted array
+///
+template <size_t N, class T, class A = AlignedAllocator<T>>
+DistributedArray<N, T, A> read_checkpoint(const std::string& filename,
+                                          int                rank,
+                                          MPI_Comm comm = MPI_COMM_WORLD) {
+
+    const auto info = read_checkpoint_info<N>(filename, comm);
+    return read_checkpoint<N, T, A>(filename,
+                                    info.topology,
+                                    rank,
+                                    info.begin_padding,
+                                    info.end_padding,
+                                    comm);
+}
+
+#if __has_include(<sys/mman.h>)
+
+///
+///@brief A read-only view to a checkpoint file written by write_checkpoint
+/// which maps the file with mmap instead of reading it. Meant for
+/// post-processing: opening is instant and only the pages of the accessed
+/// boxes are loaded. Does not require mpi.
+///
+///@tparam N the rank of the checkpointed array
+///@tparam T the element type of the checkpointed array
+///
+template <size_t N, class T> class MappedCheckpoint {
+
+public:
+    using span_type = span_base<const T, N, stdex::layout_stride>;
+
+    ///
+    ///@brief Maps the checkpoint file. Throws std::runtime_error if the file
+    /// is not a valid checkpoint of rank N with elements of type T.
+    ///
+    explicit MappedCheckpoint(const std::string& filename)
+        : m_file(filename)
+        , m_info(read_info(m_file)) {
+
+        if (m_info.element_size != sizeof(T) ||
+            m_info.element_kind != detail::checkpoint_element_kind<T>()) {
+            throw std::runtime_error(
+                "Element type mismatch in MappedCheckpoint");
+        }
+        for (auto offset : m_info.offsets) {
+            if (offset % alignof(T) != 0) {
+                throw std::runtime_error("Misaligned box in MappedCheckpoint");
+            }
+        }
+    }
+
+    ///
+    ///@brief Returns the metadata of the checkpoint.
+    ///
+    const CheckpointInfo<N>& info() const { return m_info; }
+
+    ///
+    ///@brief Returns a view to the data of the stored box j. Throws
+    /// std::out_of_range if there is no box j.
+    ///
+    span_type get_box(size_t j) const {
+        if (j >= m_info.offsets.size()) {
+            throw std::out_of_range("Box index out of range in get_box");
+        }
+        const auto* ptr =
+            reinterpret_cast<const T*>(m_file.data() + m_info.offsets[j]);
+        const auto ext = m_info.topology.get_boxes()[j].box.get_extent();
+        return span_type(span<const T, N>(ptr, ext));
+    }
+
+private:
+    MappedFile<std::byte> m_file;
+    CheckpointInfo<N>     m_info;
+
+    static CheckpointInfo<N> read_info(const MappedFile<std::byte>& file) {
+
+        // Checks the prefix and bounds the header size by the mapping
+        const uint64_t size = detail::checkpoint_header_size<N>(
+            file.data(), file.size(), file.size());
+
+        const std::vector<std::byte> header(
+            file.begin(), file.begin() + std::ptrdiff_t(size));
+        return detail::deserialize_header<N>(header, file.size());
+    }
+};
+
+///
+///@brief Returns views to the stored boxes of the checkpoint which belong to
+/// the given rank in the stored topology.
+///
+///@param checkpoint the mapped checkpoint
+///@param rank the rank in the stored topology
+///@return std::vector of views to the boxes
+///
+template <size_t N, class T>
+auto make_subspans(const MappedCheckpoint<N, T>& checkpoint, int rank) {
+
+    std::vector<typename MappedCheckpoint<N, T>::span_type> ret;
+
+    const auto& boxes = checkpoint.info().topology.get_boxes();
+    for (size_t j = 0; j < boxes.size(); ++j) {
+        if (boxes[j].rank == rank) { ret.push_back(checkpoint.get_box(j)); }
+    }
+    return ret;
+}
+
+#endif
+
+} // namespace jada
@@ -2,7 +2,13 @@
 
 #include "channel.hpp"
 #include "mpi_channel.hpp"
+#include "mpi_exchange_handle.hpp"
+#include "exchange_plan.hpp"
+#include "batch_exchange_plan.hpp"
 #include "data_exchange.hpp"
 #include "distributed_array.hpp"
+#include "distributed_io.hpp"
+#include "checkpoint.hpp"
 #include "gather.hpp"
+#include "profiler.hpp"
 
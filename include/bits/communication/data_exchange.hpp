@@ -1,7 +1,11 @@
 #pragma once
 
+#include <span>
+
 #include "channel.hpp"
 #include "mpi_channel.hpp"
+#include "exchange_plan.hpp"
+#include "mpi_exchange_handle.hpp"
 
 namespace jada {
 
@@ -31,6 +35,94 @@ void receive(auto&       data,
     }
 }
 
+///
+///@brief Posts nonblocking receives and sends of all transfers to and from the
+/// local boxes of 'rank'. The messages are matched by the sequence numbers of
+/// the transfers between each pair of processes, see receive_transfers() and
+/// send_transfers(). The transfers within 'rank' are copied directly before
+/// returning. The packing and the copies are executed according to policy.
+///
+///@param policy the execution policy to use
+///@param blocks the padded data of each local box, blocks[i] corresponds to
+/// topology.get_boxes(rank)[i]
+///@param topology the topology describing the distribution of the data
+///@param begin_padding padding at the beginning of each local box
+///@param end_padding padding at the end of each local box
+///@param rank the rank of the caller process
+///@param comm the mpi communicator
+///@return MpiExchangeHandle<N, T> a handle to the posted exchange
+///
+template <class ExecutionPolicy, size_t N, class T>
+auto post_exchange(ExecutionPolicy&&          policy,
+                   std::vector<std::span<T>>  blocks,
+                   const Topology<N>&         topology,
+                   std::array<index_type, N>  begin_padding,
+                   std::array<index_type, N>  end_padding,
+                   int                        rank,
+                   MPI_Comm                   comm) {
+
+    const auto local = topology.get_boxes(rank);
+
+    runtime_assert(blocks.size() == local.size(),
+                   "Block count mismatch in post_exchange");
+
+    MpiExchangeHandle<N, T> handle(comm);
+
+    {
+        ScopedTimer timer(Phase::Post);
+        for (const auto& t :
+             receive_transfers(topology, begin_padding, end_padding, rank)) {
+
+            auto padded_extent = add_padding(
+                local[t.block].get_extent(), begin_padding, end_padding);
+            auto big_span = make_span(blocks[t.block], padded_extent);
+
+            auto end    = get_end(t.info.receiver_begin, t.info.extent);
+            auto target = make_subspan(big_span, t.info.receiver_begin, end);
+            handle.post_receive(t.info, target, t.tag);
+        }
+    }
+
+    const auto sends =
+        send_transfers(topology, begin_padding, end_padding, rank);
+
+    std::vector<std::vector<T>> buffers(sends.size());
+    {
+        ScopedTimer timer(Phase::Pack);
+        for_each_concurrent(policy, sends.size(), [&](size_t i) {
+            const auto& t = sends[i];
+            buffers[i]    = make_sendable_slice(policy,
+                                             blocks[t.block],
+                                             local[t.block],
+                                             begin_padding,
+                                             end_padding,
+                                             t.info);
+        });
+    }
+
+    {
+        ScopedTimer timer(Phase::Post);
+        for (size_t i = 0; i < sends.size(); ++i) {
+            handle.post_send(
+                sends[i].info, std::move(buffers[i]), sends[i].tag);
+        }
+    }
+
+    std::vector<std::array<size_type, N>> dims;
+    for (const auto& box : local) {
+        dims.push_back(extent_to_array(
+            add_padding(box.get_extent(), begin_padding, end_padding)));
+    }
+    const auto locals =
+        local_transfers(topology, begin_padding, end_padding, rank);
+    ScopedTimer timer(Phase::LocalCopy);
+    for_each_concurrent(policy, locals.size(), [&](size_t i) {
+        copy_local(policy, locals[i], blocks, dims);
+    });
+
+    return handle;
+}
+
 } // namespace detail
 
 template <class Data, size_t N>
@@ -48,6 +140,84 @@ void send_receive(Data&                     data,
     detail::receive(data, topology, begin_padding, end_padding, channel, rank);
 }
 
+///
+///@brief Starts a nonblocking halo exchange of the input data. All the
+/// messages of the exchange are posted at once and complete in parallel. The
+/// padding of the input data is up to date after wait() or a successful test()
+/// has been called on the returned handle. The input data must not be
+/// modified nor destroyed before the exchange has completed. If several
+/// exchanges are in flight simultaneously, all processes must start them in the
+/// same order.
+///
+///@param data the padded data of the local box of 'rank'
+///@param topology the topology describing the distribution of the data
+///@param begin_padding padding at the beginning of the local box
+///@param end_padding padding at the end of the local box
+///@param rank the rank of the caller process
+///@param comm the mpi communicator (defaults to MPI_COMM_WORLD)
+///@return MpiExchangeHandle<N, T> a handle to wait() or test() on
+///
+template <class Data, size_t N>
+auto mpi_send_receive_async(Data&                     data,
+                            const Topology<N>&        topology,
+                            std::array<index_type, N> begin_padding,
+                            std::array<index_type, N> end_padding,
+                            int                       rank,
+                            MPI_Comm                  comm = MPI_COMM_WORLD) {
+
+    return mpi_send_receive_async(std::execution::seq,
+                                  data,
+                                  topology,
+                                  begin_padding,
+                                  end_padding,
+                                  rank,
+                                  comm);
+}
+
+///
+///@brief Starts a nonblocking halo exchange of the input data, see the
+/// overload without a policy. The packing of the sent data and the copies
+/// within the process are executed according to policy.
+///
+///@param policy the execution policy to use
+///@param data the padded data of the local box of 'rank'
+///@param topology the topology describing the distribution of the data
+///@param begin_padding padding at the beginning of the local box
+///@param end_padding padding at the end of the local box
+///@param rank the rank of the caller process
+///@param comm the mpi communicator (defaults to MPI_COMM_WORLD)
+///@return MpiExchangeHandle<N, T> a handle to wait() or test() on
+///
+template <class ExecutionPolicy, class Data, size_t N>
+auto mpi_send_receive_async(ExecutionPolicy&&         policy,
+                            Data&                     data,
+                            const Topology<N>&        topology,
+                            std::array<index_type, N> begin_padding,
+                            std::array<index_type, N> end_padding,
+                            int                       rank,
+                            MPI_Comm                  comm = MPI_COMM_WORLD) {
+
+    using T = typename Data::value_type;
+
+    // All local boxes share the same data, see detail::send
+    std::vector<std::span<T>> blocks(topology.get_boxes(rank).size(),
+                                     std::span<T>(std::data(data),
+                                                  std::size(data)));
+
+    return detail::post_exchange(
+        policy, blocks, topology, begin_padding, end_padding, rank, comm);
+}
+
+///
+///@brief Performs a halo exchange of the input data. Blocks until the padding
+/// of the input data is up to date.
+///
+///@param data the padded data of the local box of 'rank'
+///@param topology the topology describing the distribution of the data
+///@param begin_padding padding at the beginning of the local box
+///@param end_padding padding at the end of the local box
+///@param rank the rank of the caller process
+///
 template <class Data, size_t N>
 void mpi_send_receive(Data&                     data,
                       const Topology<N>&        topology,
@@ -55,12 +225,8 @@ void mpi_send_receive(Data&                     data,
                       std::array<index_type, N> end_padding,
                       int                       rank) {
 
-    using T = typename Data::value_type;
-
-    MpiChannel<N, T> channel;
-
-    detail::send(data, topology, begin_padding, end_padding, channel, rank);
-    detail::receive(data, topology, begin_padding, end_padding, channel, rank);
+    mpi_send_receive_async(data, topology, begin_padding, end_padding, rank)
+        .wait();
 }
 
 } // namespace jada
\ No newline at end of file
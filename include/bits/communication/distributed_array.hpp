@@ -1,6 +1,16 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <execution>
+#include <numeric>
+#include <span>
+#include <tuple>
+#include <vector>
+
+#include "batch_exchange_plan.hpp"
 #include "channel.hpp"
+#include "data_exchange.hpp"
 #include "gather.hpp"
 #include "include/bits/algorithms/algorithms.hpp"
 #include "include/bits/core/tuple_extensions.hpp"
@@ -8,35 +18,211 @@
 
 namespace jada {
 
-template <size_t N, class T> struct DistributedArray {
+///
+///@brief Tag selecting a DistributedArray constructor which leaves trivial
+/// elements uninitialized.
+///
+struct Uninitialized {};
+
+///
+///@brief A multidimensional array distributed according to a topology. The
+/// local boxes of the array, including their padding, are stored in a single
+/// allocation where each box begins on a JADA_ALIGNMENT boundary. The views
+/// to the boxes and the unpadded subspans are created once on construction,
+/// so that the algorithms do not allocate when iterating over the local data.
+///
+///@tparam N the rank of the array
+///@tparam T the element type
+///@tparam Allocator the allocator of the storage, e.g. AlignedAllocator<T>
+/// or HugePageAllocator<T>
+///
+template <size_t N, class T, class Allocator = AlignedAllocator<T>>
+struct DistributedArray {
 
+    using allocator_type = Allocator;
+    using storage_type   = std::vector<T, DefaultInitAllocator<T, Allocator>>;
+    using span_type      = span_base<T, N, stdex::layout_stride>;
+    using cspan_type     = span_base<const T, N, stdex::layout_stride>;
+
+    ///
+    ///@brief Constructs the array with all elements set to T{}.
+    ///
     DistributedArray(int                       rank,
                      Topology<N>               topology,
                      std::array<index_type, N> begin_padding,
-                     std::array<index_type, N> end_padding)
+                     std::array<index_type, N> end_padding,
+                     const Allocator&          alloc = Allocator())
+        : DistributedArray(std::execution::seq,
+                           rank,
+                           topology,
+                           begin_padding,
+                           end_padding,
+                           alloc) {}
+
+    ///
+    ///@brief Constructs the array with all elements set to T{}. The boxes are
+    /// initialized according to policy, so with a parallel policy and an
+    /// allocator which does not touch the memory, the pages are first touched
+    /// by the threads which will later process them.
+    ///
+    template <class ExecutionPolicy>
+        requires std::is_execution_policy_v<
+            std::remove_cvref_t<ExecutionPolicy>>
+    DistributedArray(ExecutionPolicy&&         policy,
+                     int                       rank,
+                     Topology<N>               topology,
+                     std::array<index_type, N> begin_padding,
+                     std::array<index_type, N> end_padding,
+                     const Allocator&          alloc = Allocator())
+        : DistributedArray(Uninitialized{},
+                           rank,
+                           topology,
+                           begin_padding,
+                           end_padding,
+                           alloc) {
+
+        for (const auto& block : m_blocks) {
+            std::fill(policy, block.begin(), block.end(), T{});
+        }
+    }
+
+    ///
+    ///@brief Constructs the array with default-initialized elements, i.e.
+    /// trivial elements of the boxes are left uninitialized and their memory
+    /// is not touched. Only the small alignment gaps between the boxes are
+    /// set to T{}.
+    ///
+    DistributedArray(Uninitialized,
+                     int                       rank,
+                     Topology<N>               topology,
+                     std::array<index_type, N> begin_padding,
+                     std::array<index_type, N> end_padding,
+                     const Allocator&          alloc = Allocator())
         : m_rank(rank)
         , m_topology(topology)
         , m_begin_padding(begin_padding)
-        , m_end_padding(end_padding) {
+        , m_end_padding(end_padding)
+        , m_storage(alloc) {
 
         runtime_assert(m_topology.is_valid(), "Not a valid topology");
 
-        for (auto box : m_topology.get_boxes(m_rank)) {
+        m_local_boxes = m_topology.get_boxes(m_rank);
+
+        // Offsets of the boxes in elements, rounded up to the alignment
+        constexpr size_t step =
+            JADA_ALIGNMENT / std::gcd(size_t(JADA_ALIGNMENT), sizeof(T));
+
+        size_t offset = 0;
+        for (const auto& box : m_local_boxes) {
             auto ext  = box.get_extent();
             auto pext = add_padding(ext, m_begin_padding, m_end_padding);
-            auto data = std::vector<T>(flat_size(pext), T(0));
-            m_data.push_back(data);
+            m_offsets.push_back(offset);
+            m_sizes.push_back(flat_size(pext));
+            offset += (m_sizes.back() + step - 1) / step * step;
+        }
+
+        m_storage.resize(offset);
+
+        // The alignment gaps are exposed by get_local_storage() and copied
+        // with the array, so they are always value-initialized
+        for (size_t i = 0; i < m_offsets.size(); ++i) {
+            const size_t gap_begin = m_offsets[i] + m_sizes[i];
+            const size_t gap_end   = i + 1 < m_offsets.size() ? m_offsets[i + 1]
+                                                              : offset;
+            std::fill(m_storage.begin() + std::ptrdiff_t(gap_begin),
+                      m_storage.begin() + std::ptrdiff_t(gap_end),
+                      T{});
+        }
+
+        update_views();
+    }
+
+    DistributedArray(const DistributedArray& other)
+        : m_rank(other.m_rank)
+        , m_topology(other.m_topology)
+        , m_begin_padding(other.m_begin_padding)
+        , m_end_padding(other.m_end_padding)
+        , m_local_boxes(other.m_local_boxes)
+        , m_offsets(other.m_offsets)
+        , m_sizes(other.m_sizes)
+        , m_storage(other.m_storage) {
+        update_views();
+    }
+
+    DistributedArray& operator=(const DistributedArray& other) {
+        if (this != &other) {
+            m_rank          = other.m_rank;
+            m_topology      = other.m_topology;
+            m_begin_padding = other.m_begin_padding;
+            m_end_padding   = other.m_end_padding;
+            m_local_boxes   = other.m_local_boxes;
+            m_offsets       = other.m_offsets;
+            m_sizes         = other.m_sizes;
+            m_storage       = other.m_storage;
+            update_views();
+        }
+        return *this;
+    }
+
+    // Move construction always takes over the buffer of the storage, so the
+    // views stay valid
+    DistributedArray(DistributedArray&& other) noexcept
+        : m_rank(other.m_rank)
+        , m_topology(std::move(other.m_topology))
+        , m_begin_padding(other.m_begin_padding)
+        , m_end_padding(other.m_end_padding)
+        , m_local_boxes(std::move(other.m_local_boxes))
+        , m_offsets(std::move(other.m_offsets))
+        , m_sizes(std::move(other.m_sizes))
+        , m_storage(std::move(other.m_storage))
+        , m_blocks(std::move(other.m_blocks))
+        , m_const_blocks(std::move(other.m_const_blocks))
+        , m_subspans(std::move(other.m_subspans))
+        , m_const_subspans(std::move(other.m_const_subspans)) {}
+
+    // Move assignment copies the elements to a new buffer if the allocators
+    // are unequal and do not propagate, so the views are recreated
+    DistributedArray& operator=(DistributedArray&& other) {
+        if (this != &other) {
+            m_rank          = other.m_rank;
+            m_topology      = std::move(other.m_topology);
+            m_begin_padding = other.m_begin_padding;
+            m_end_padding   = other.m_end_padding;
+            m_local_boxes   = std::move(other.m_local_boxes);
+            m_offsets       = std::move(other.m_offsets);
+            m_sizes         = std::move(other.m_sizes);
+            m_storage       = std::move(other.m_storage);
+            update_views();
         }
+        return *this;
     }
 
     const auto& topology() const { return m_topology; }
-    const auto& get_local_data() const { return m_data; }
-    auto&       get_local_data() { return m_data; }
+
+    ///
+    ///@brief Returns views to the padded local boxes.
+    ///
+    const auto& get_local_data() const { return m_const_blocks; }
+    const std::vector<std::span<T>>& get_local_data() { return m_blocks; }
+
+    ///
+    ///@brief Returns a view to the whole local allocation holding all the
+    /// boxes, including the alignment gaps between them. The gaps are always
+    /// set to T{}.
+    ///
+    std::span<const T> get_local_storage() const { return m_storage; }
+    std::span<T>       get_local_storage() { return m_storage; }
+
+    ///
+    ///@brief Returns the unpadded subspans of the local boxes.
+    ///
+    const auto& get_local_subspans() const { return m_const_subspans; }
+    const auto& get_local_subspans() { return m_subspans; }
 
     auto get_begin_padding() const { return m_begin_padding; }
     auto get_end_padding() const { return m_end_padding; }
 
-    size_t get_local_subdomain_count() const { return m_data.size(); }
+    size_t get_local_subdomain_count() const { return m_local_boxes.size(); }
 
     // Note this does not in general equal to number of processes
     size_t get_global_subdomain_count() const {
@@ -52,8 +238,8 @@ template <size_t N, class T> struct DistributedArray {
     ///@return std::vector<BoxRankPair<N>> A vector of box-rank pairs where the
     /// rank is always m_rank.
     ///
-    std::vector<BoxRankPair<N>> get_local_boxes() const {
-        return m_topology.get_boxes(m_rank);
+    const std::vector<BoxRankPair<N>>& get_local_boxes() const {
+        return m_local_boxes;
     }
 
 private:
@@ -61,7 +247,47 @@ private:
     Topology<N>                 m_topology;
     std::array<index_type, N>   m_begin_padding;
     std::array<index_type, N>   m_end_padding;
-    std::vector<std::vector<T>> m_data;
+    std::vector<BoxRankPair<N>> m_local_boxes;
+    std::vector<size_t>         m_offsets;
+    std::vector<size_t>         m_sizes;
+    storage_type                m_storage;
+
+    std::vector<std::span<T>>       m_blocks;
+    std::vector<std::span<const T>> m_const_blocks;
+    std::vector<span_type>          m_subspans;
+    std::vector<cspan_type>         m_const_subspans;
+
+    ///
+    ///@brief Creates the views to the boxes in m_storage.
+    ///
+    void update_views() {
+
+        m_blocks.clear();
+        m_const_blocks.clear();
+        m_subspans.clear();
+        m_const_subspans.clear();
+
+        for (size_t i = 0; i < m_local_boxes.size(); ++i) {
+
+            std::span<T> block(m_storage.data() + m_offsets[i], m_sizes[i]);
+
+            auto unpadded_extent = m_local_boxes[i].box.get_extent();
+            auto padded_extent =
+                add_padding(unpadded_extent, m_begin_padding, m_end_padding);
+
+            auto sbegin = m_begin_padding;
+            auto send =
+                get_end(m_begin_padding, extent_to_array(unpadded_extent));
+
+            auto bigspan  = make_span(block, padded_extent);
+            auto cbigspan = make_span(std::span<const T>(block), padded_extent);
+
+            m_blocks.push_back(block);
+            m_const_blocks.push_back(block);
+            m_subspans.push_back(make_subspan(bigspan, sbegin, send));
+            m_const_subspans.push_back(make_subspan(cbigspan, sbegin, send));
+        }
+    }
 };
 
 ///
@@ -71,10 +297,11 @@ private:
 ///@param array The input array to query the local element count from.
 ///@return size_t The element count without padding held by the input array.
 ///
-template <size_t N, class T>
-static inline size_t local_element_count(const DistributedArray<N, T>& array) {
+template <size_t N, class T, class A>
+static inline size_t
+local_element_count(const DistributedArray<N, T, A>& array) {
 
-    auto   boxes = array.get_local_boxes();
+    const auto& boxes = array.get_local_boxes();
     size_t size  = 0;
     for (auto box : boxes) {
         auto ext = box.get_extent();
@@ -90,8 +317,9 @@ static inline size_t local_element_count(const DistributedArray<N, T>& array) {
 ///@param array The input array to query the global element count from.
 ///@return size_t The global element count without padding.
 ///
-template <size_t N, class T>
-static inline size_t global_element_count(const DistributedArray<N, T>& array) {
+template <size_t N, class T, class A>
+static inline size_t
+global_element_count(const DistributedArray<N, T, A>& array) {
 
     return flat_size(array.topology().get_domain().get_extent());
 }
@@ -103,8 +331,8 @@ static inline size_t global_element_count(const DistributedArray<N, T>& array) {
 ///@param array The input array to query the local capacity from.
 ///@return size_t The local capacity with padding held by the input array.
 ///
-template <size_t N, class T>
-static inline size_t local_capacity(const DistributedArray<N, T>& array) {
+template <size_t N, class T, class A>
+static inline size_t local_capacity(const DistributedArray<N, T, A>& array) {
 
     size_t size = 0;
     for (const auto& v : array.get_local_data()) { size += v.size(); }
@@ -112,68 +340,23 @@ static inline size_t local_capacity(const DistributedArray<N, T>& array) {
 }
 
 /// @brief Returns the unpadded subspans to local data held by the input
-/// distributed array.
+/// distributed array. The subspans are cached in the array, so no allocation
+/// takes place.
 /// @param array The input array to get the subspans to local data.
 /// @return The subspans to local data held by the input array.
-template <size_t N, class T>
-auto make_subspans(const DistributedArray<N, T>& array) {
-
-    using span_t = span_base<const T, N, stdex::layout_stride>;
-
-    std::vector<span_t> ret;
-
-    const auto& data  = array.get_local_data();
-    auto        boxes = array.get_local_boxes();
-
-    auto bpad = array.get_begin_padding();
-    auto epad = array.get_end_padding();
-
-    for (size_t i = 0; i < data.size(); ++i) {
-
-        auto unpadded_extent = boxes[i].box.get_extent();
-        auto padded_extent   = add_padding(unpadded_extent, bpad, epad);
-
-        auto sbegin = bpad;
-        auto send   = get_end(bpad, extent_to_array(unpadded_extent));
-
-        auto bigspan = make_span(data[i], padded_extent);
-        auto sspan   = make_subspan(bigspan, sbegin, send);
-
-        ret.push_back(sspan);
-    }
-    return ret;
+template <size_t N, class T, class A>
+const auto& make_subspans(const DistributedArray<N, T, A>& array) {
+    return array.get_local_subspans();
 }
 
 /// @brief Returns the unpadded subspans to local data held by the input
-/// distributed array.
+/// distributed array. The subspans are cached in the array, so no allocation
+/// takes place.
 /// @param array The input array to get the subspans to local data.
 /// @return The subspans to local data held by the input array.
-template <size_t N, class T> auto make_subspans(DistributedArray<N, T>& array) {
-
-    using span_t = span_base<T, N, stdex::layout_stride>;
-
-    std::vector<span_t> ret;
-
-    auto& data  = array.get_local_data();
-    auto  boxes = array.get_local_boxes();
-
-    auto bpad = array.get_begin_padding();
-    auto epad = array.get_end_padding();
-
-    for (size_t i = 0; i < data.size(); ++i) {
-
-        auto unpadded_extent = boxes[i].box.get_extent();
-        auto padded_extent   = add_padding(unpadded_extent, bpad, epad);
-
-        auto sbegin = bpad;
-        auto send   = get_end(bpad, extent_to_array(unpadded_extent));
-
-        auto bigspan = make_span(data[i], padded_extent);
-        auto sspan   = make_subspan(bigspan, sbegin, send);
-
-        ret.push_back(sspan);
-    }
-    return ret;
+template <size_t N, class T, class A>
+const auto& make_subspans(DistributedArray<N, T, A>& array) {
+    return array.get_local_subspans();
 }
 
 /// @brief Serializes the local data of the input distributed array to a flat
@@ -181,13 +364,13 @@ template <size_t N, class T> auto make_subspans(DistributedArray<N, T>& array) {
 /// @param array The input array to serialize.
 /// @return A flat std::vector of the same element type containing the local
 /// data the input array holds.
-template <size_t N, class T>
+template <size_t N, class T, class A>
 static inline std::vector<T>
-serialize_local(const DistributedArray<N, T>& array) {
+serialize_local(const DistributedArray<N, T, A>& array) {
 
     auto size = local_element_count(array);
 
-    auto spans = make_subspans(array);
+    const auto& spans = make_subspans(array);
 
     // Offsets in the output array where to begin writing
     std::vector<size_t> offsets = [&]() {
@@ -215,7 +398,9 @@ serialize_local(const DistributedArray<N, T>& array) {
 ///
 ///@brief Given an stl-like container of data, creates a distributed array
 /// slicing the local portions of the input container based on the input
-/// topology and rank.
+/// topology and rank. Every process has to hold the global data, see
+/// scatter_from_root and the generator overload of distribute for large
+/// domains.
 ///
 ///@param data An stl-like contiguous container from which the local portion is
 /// sliced.
@@ -239,8 +424,8 @@ auto distribute(const Data&               data,
 
     DistributedArray<N, T> ret(rank, topo, begin_padding, end_padding);
 
-    auto d_array_spans = make_subspans(ret);
-    auto data_spans    = make_subspans(data, topo, rank);
+    const auto& d_array_spans = make_subspans(ret);
+    const auto  data_spans    = make_subspans(data, topo, rank);
 
     for (size_t i = 0; i < data_spans.size(); ++i) {
         transform(data_spans[i], d_array_spans[i], [](auto r) { return r; });
@@ -258,10 +443,11 @@ auto distribute(const Data&               data,
 ///@param array The input array to convert to an std::vector.
 ///@return std::vector<T> A flat vector of global size of the distributed array
 /// where the subportion data is gathered from all caller processes. Each caller
-/// process gets the same data.
+/// process gets the same data. For large arrays prefer gather_to_root or
+/// write_row_major, which do not replicate the domain on every process.
 ///
-template <size_t N, class T>
-std::vector<T> to_vector(const DistributedArray<N, T>& array) {
+template <size_t N, class T, class A>
+std::vector<T> to_vector(const DistributedArray<N, T, A>& array) {
 
     auto data = all_gather(serialize_local(array));
 
@@ -305,6 +491,294 @@ std::vector<T> to_vector(const DistributedArray<N, T>& array) {
     return global;
 }
 
+///
+///@brief Returns flat views to the padded data of the local blocks of the input
+/// array in the order of get_local_boxes().
+///
+///@param array the array to view
+///@return std::vector<std::span<T>> views to the local blocks
+///
+template <size_t N, class T, class A>
+std::vector<std::span<T>> local_blocks(DistributedArray<N, T, A>& array) {
+    return array.get_local_data();
+}
+
+///
+///@brief Creates an exchange plan for repeated halo exchanges of the input
+/// array or any other array with the same topology, padding and rank.
+///
+///@param array the array to create the plan for
+///@param method packed buffers or in-place subarray datatypes
+///@param comm the mpi communicator (defaults to MPI_COMM_WORLD)
+///@return ExchangePlan<N, T> the precomputed exchange
+///
+template <size_t N, class T, class A>
+auto make_exchange_plan(
+    const DistributedArray<N, T, A>& array,
+    ExchangeMethod                   method = ExchangeMethod::Pack,
+    MPI_Comm                         comm = MPI_COMM_WORLD) {
+    return ExchangePlan<N, T>(array.topology(),
+                              array.get_begin_padding(),
+                              array.get_end_padding(),
+                              array.get_rank(),
+                              method,
+                              comm);
+}
+
+///
+///@brief Starts a halo exchange of the padding of all local blocks of the input
+/// array using a precomputed plan. The padding is up to date after wait() or a
+/// successful test() has been called on the returned plan.
+///
+///@param array the array whose padding is exchanged
+///@param plan a plan created for the topology, padding and rank of the array
+///@return ExchangePlan<N, T>& the input plan to wait() or test() on
+///
+template <size_t N, class T, class A>
+ExchangePlan<N, T>& mpi_send_receive_async(DistributedArray<N, T, A>& array,
+                                           ExchangePlan<N, T>&        plan) {
+    return mpi_send_receive_async(std::execution::seq, array, plan);
+}
+
+///
+///@brief Starts a halo exchange of the padding of all local blocks of the input
+/// array using a precomputed plan. The packing is executed according to
+/// policy. The padding is up to date after wait() or a successful test() has
+/// been called on the returned plan, preferably with the same policy.
+///
+///@param policy the execution policy to use
+///@param array the array whose padding is exchanged
+///@param plan a plan created for the topology, padding and rank of the array
+///@return ExchangePlan<N, T>& the input plan to wait() or test() on
+///
+template <class ExecutionPolicy, size_t N, class T, class A>
+ExchangePlan<N, T>& mpi_send_receive_async(ExecutionPolicy&&          policy,
+                                           DistributedArray<N, T, A>& array,
+                                           ExchangePlan<N, T>&        plan) {
+    plan.start(policy, local_blocks(array));
+    return plan;
+}
+
+///
+///@brief Performs a halo exchange of the padding of all local blocks of the
+/// input array using a precomputed plan. Blocks until the padding is up to
+/// date.
+///
+///@param array the array whose padding is exchanged
+///@param plan a plan created for the topology, padding and rank of the array
+///
+template <size_t N, class T, class A>
+void mpi_send_receive(DistributedArray<N, T, A>& array,
+                      ExchangePlan<N, T>&        plan) {
+    mpi_send_receive(std::execution::seq, array, plan);
+}
+
+///
+///@brief Performs a halo exchange of the padding of all local blocks of the
+/// input array using a precomputed plan. The packing and unpacking are
+/// executed according to policy. Blocks until the padding is up to date.
+///
+///@param policy the execution policy to use
+///@param array the array whose padding is exchanged
+///@param plan a plan created for the topology, padding and rank of the array
+///
+template <class ExecutionPolicy, size_t N, class T, class A>
+void mpi_send_receive(ExecutionPolicy&&          policy,
+                      DistributedArray<N, T, A>& array,
+                      ExchangePlan<N, T>&        plan) {
+    mpi_send_receive_async(policy, array, plan).wait(policy);
+}
+
+///
+///@brief Starts a nonblocking halo exchange of the padding of all local blocks
+/// of the input array. The padding is up to date after wait() or a successful
+/// test() has been called on the returned handle. The array must not be
+/// modified nor destroyed before the exchange has completed.
+///
+///@param array the array whose padding is exchanged
+///@param comm the mpi communicator (defaults to MPI_COMM_WORLD)
+///@return MpiExchangeHandle<N, T> a handle to wait() or test() on
+///
+template <size_t N, class T, class A>
+auto mpi_send_receive_async(DistributedArray<N, T, A>& array,
+                            MPI_Comm                   comm = MPI_COMM_WORLD) {
+    return mpi_send_receive_async(std::execution::seq, array, comm);
+}
+
+///
+///@brief Starts a nonblocking halo exchange of the padding of all local blocks
+/// of the input array. The packing is executed according to policy. The
+/// padding is up to date after wait() or a successful test() has been called on
+/// the returned handle, preferably with the same policy.
+///
+///@param policy the execution policy to use
+///@param array the array whose padding is exchanged
+///@param comm the mpi communicator (defaults to MPI_COMM_WORLD)
+///@return MpiExchangeHandle<N, T> a handle to wait() or test() on
+///
+template <class ExecutionPolicy, size_t N, class T, class A>
+auto mpi_send_receive_async(ExecutionPolicy&&          policy,
+                            DistributedArray<N, T, A>& array,
+                            MPI_Comm                   comm = MPI_COMM_WORLD) {
+
+    return detail::post_exchange(policy,
+                                 local_blocks(array),
+                                 array.topology(),
+                                 array.get_begin_padding(),
+                                 array.get_end_padding(),
+                                 array.get_rank(),
+                                 comm);
+}
+
+///
+///@brief Performs a halo exchange of the padding of all local blocks of the
+/// input array. Blocks until the padding is up to date.
+///
+///@param array the array whose padding is exchanged
+///@param comm the mpi communicator (defaults to MPI_COMM_WORLD)
+///
+template <size_t N, class T, class A>
+void mpi_send_receive(DistributedArray<N, T, A>& array,
+                      MPI_Comm                   comm = MPI_COMM_WORLD) {
+    mpi_send_receive(std::execution::seq, array, comm);
+}
+
+///
+///@brief Performs a halo exchange of the padding of all local blocks of the
+/// input array. The packing and unpacking are executed according to policy.
+/// Blocks until the padding is up to date.
+///
+///@param policy the execution policy to use
+///@param array the array whose padding is exchanged
+///@param comm the mpi communicator (defaults to MPI_COMM_WORLD)
+///
+template <class ExecutionPolicy, size_t N, class T, class A>
+void mpi_send_receive(ExecutionPolicy&&          policy,
+                      DistributedArray<N, T, A>& array,
+                      MPI_Comm                   comm = MPI_COMM_WORLD) {
+    mpi_send_receive_async(policy, array, comm).wait(policy);
+}
+
+///
+///@brief Checks if the two input arrays are distributed identically, i.e. they
+/// have the same topology, padding and rank.
+///
+///@param lhs the first array
+///@param rhs the second array
+///@return true if the distributions match, false otherwise
+///
+template <size_t N, class T1, class A1, class T2, class A2>
+bool same_distribution(const DistributedArray<N, T1, A1>& lhs,
+                       const DistributedArray<N, T2, A2>& rhs) {
+    return lhs.get_rank() == rhs.get_rank() &&
+           lhs.topology().get_domain() == rhs.topology().get_domain() &&
+           lhs.topology().get_boxes() == rhs.topology().get_boxes() &&
+           lhs.get_begin_padding() == rhs.get_begin_padding() &&
+           lhs.get_end_padding() == rhs.get_end_padding();
+}
+
+///
+///@brief Creates an exchange plan for repeated halo exchanges of several
+/// arrays at once. The arrays must be distributed identically but may have
+/// different element types.
+///
+///@param arrays the arrays to create the plan for, e.g. std::tie(rho, u, e)
+///@param comm the mpi communicator (defaults to MPI_COMM_WORLD)
+///@return BatchExchangePlan<N, Ts...> the precomputed exchange
+///
+template <size_t N, class T, class A, class... Ts, class... As>
+auto make_exchange_plan(
+    const std::tuple<DistributedArray<N, T, A>&,
+                     DistributedArray<N, Ts, As>&...>& arrays,
+    MPI_Comm                                           comm = MPI_COMM_WORLD) {
+
+    const auto& first = std::get<0>(arrays);
+    std::apply(
+        [&](const auto&... array) {
+            runtime_assert((same_distribution(first, array) && ...),
+                           "Batched arrays are not distributed identically");
+        },
+        arrays);
+
+    return BatchExchangePlan<N, T, Ts...>(first.topology(),
+                                          first.get_begin_padding(),
+                                          first.get_end_padding(),
+                                          first.get_rank(),
+                                          comm);
+}
+
+///
+///@brief Starts a halo exchange of the padding of all local blocks of several
+/// arrays in one aggregated round using a precomputed plan. The padding is up
+/// to date after wait() or a successful test() has been called on the
+/// returned plan.
+///
+///@param arrays the arrays whose padding is exchanged, e.g. std::tie(rho, u, e)
+///@param plan a plan created for the arrays
+///@return BatchExchangePlan<N, Ts...>& the input plan to wait() or test() on
+///
+template <size_t N, class... Ts, class... As>
+auto& mpi_send_receive_async(
+    const std::tuple<DistributedArray<N, Ts, As>&...>& arrays,
+    BatchExchangePlan<N, Ts...>&                       plan) {
+
+    std::apply([&](auto&... array) { plan.start(local_blocks(array)...); },
+               arrays);
+    return plan;
+}
+
+///
+///@brief Performs a halo exchange of the padding of all local blocks of
+/// several arrays in one aggregated round using a precomputed plan. Blocks
+/// until the padding is up to date.
+///
+///@param arrays the arrays whose padding is exchanged, e.g. std::tie(rho, u, e)
+///@param plan a plan created for the arrays
+///
+template <size_t N, class... Ts, class... As>
+void mpi_send_receive(const std::tuple<DistributedArray<N, Ts, As>&...>& arrays,
+                      BatchExchangePlan<N, Ts...>&                       plan) {
+    mpi_send_receive_async(arrays, plan).wait();
+}
+
+///
+///@brief Performs a halo exchange of the padding of all local blocks of
+/// several arrays in one aggregated round using a precomputed plan. The
+/// packing and unpacking are executed according to policy. Blocks until the
+/// padding is up to date.
+///
+///@param policy the execution policy to use
+///@param arrays the arrays whose padding is exchanged, e.g. std::tie(rho, u, e)
+///@param plan a plan created for the arrays
+///
+template <class ExecutionPolicy, size_t N, class... Ts, class... As>
+void mpi_send_receive(ExecutionPolicy&&                                  policy,
+                      const std::tuple<DistributedArray<N, Ts, As>&...>& arrays,
+                      BatchExchangePlan<N, Ts...>&                       plan) {
+    std::apply(
+        [&](auto&... array) { plan.start(policy, local_blocks(array)...); },
+        arrays);
+    plan.wait(policy);
+}
+
+///
+///@brief Performs a halo exchange of the padding of all local blocks of
+/// several arrays in one aggregated round. Blocks until the padding is up to
+/// date. For repeated exchanges, create the plan once with
+/// make_exchange_plan().
+///
+///@param arrays the arrays whose padding is exchanged, e.g. std::tie(rho, u, e)
+///@param comm the mpi communicator (defaults to MPI_COMM_WORLD)
+///
+template <size_t N, class T, class A, class... Ts, class... As>
+void mpi_send_receive(
+    const std::tuple<DistributedArray<N, T, A>&,
+                     DistributedArray<N, Ts, As>&...>& arrays,
+    MPI_Comm                                           comm = MPI_COMM_WORLD) {
+    auto plan = make_exchange_plan(arrays, comm);
+    mpi_send_receive(arrays, plan);
+}
+
 /*
 //TODO: This should return a Distributed array with all subportions converted to
 local subportions. For some reason the topology information is not correctly
@@ -333,11 +807,16 @@ array) {
 /// @param policy the execution policy to use. See execution policy for details.
 /// @param arr the input array.
 /// @param f function object, to be applied to the result of subspan(md_idx).
-template <class ExecutionPolicy, size_t N, class T, class UnaryFunction>
-static inline void for_each(ExecutionPolicy&&       policy,
-                            DistributedArray<N, T>& arr,
-                            UnaryFunction           f) {
+template <class ExecutionPolicy,
+          size_t N,
+          class T,
+          class A,
+          class UnaryFunction>
+static inline void for_each(ExecutionPolicy&&          policy,
+                            DistributedArray<N, T, A>& arr,
+                            UnaryFunction              f) {
 
+    ScopedTimer timer(Phase::Kernel);
     for (auto span : make_subspans(arr)) { for_each(policy, span, f); }
 }
 
@@ -345,8 +824,8 @@ static inline void for_each(ExecutionPolicy&&       policy,
 /// array. Executed in order.
 /// @param arr the input array.
 /// @param f function object, to be applied to the result of subspan(md_idx).
-template <size_t N, class T, class UnaryFunction>
-static inline void for_each(DistributedArray<N, T>& arr, UnaryFunction f) {
+template <size_t N, class T, class A, class UnaryFunction>
+static inline void for_each(DistributedArray<N, T, A>& arr, UnaryFunction f) {
 
     for_each(std::execution::seq, arr, f);
 }
@@ -361,13 +840,19 @@ static inline void for_each(DistributedArray<N, T>& arr, UnaryFunction f) {
 /// @param f binary function object where the first argument is the current
 /// (global) multidimensional index, to be applied to the result of
 /// subspan(local_md_idx).
-template <class ExecutionPolicy, size_t N, class T, class BinaryIndexFunction>
-static inline void for_each_indexed(ExecutionPolicy&&       policy,
-                                    DistributedArray<N, T>& arr,
-                                    BinaryIndexFunction     f) {
+template <class ExecutionPolicy,
+          size_t N,
+          class T,
+          class A,
+          class BinaryIndexFunction>
+static inline void for_each_indexed(ExecutionPolicy&&          policy,
+                                    DistributedArray<N, T, A>& arr,
+                                    BinaryIndexFunction        f) {
+
+    ScopedTimer timer(Phase::Kernel);
 
-    const auto boxes    = arr.get_local_boxes();
-    const auto subspans = make_subspans(arr);
+    const auto& boxes    = arr.get_local_boxes();
+    const auto& subspans = make_subspans(arr);
     for (size_t i = 0; i < subspans.size(); ++i) {
         auto offset = boxes[i].box.begin;
         auto span   = subspans[i];
@@ -388,112 +873,543 @@ static inline void for_each_indexed(ExecutionPolicy&&       policy,
 /// @param f binary function object where the first argument is the current
 /// (global) multidimensional index, to be applied to the result of
 /// subspan(local_md_idx).
-template <size_t N, class T, class BinaryIndexFunction>
-static inline void for_each_indexed(DistributedArray<N, T>& arr,
-                                    BinaryIndexFunction     f) {
+template <size_t N, class T, class A, class BinaryIndexFunction>
+static inline void for_each_indexed(DistributedArray<N, T, A>& arr,
+                                    BinaryIndexFunction        f) {
 
     for_each_indexed(std::execution::seq, arr, f);
 }
 
-/// @brief Applies the given function to every element (not necessarily in
-/// order) of the input distributed array and stores the result in the output
-/// distributed array of same extent. Executed according to policy (not
-/// necessarily in order).
-/// @param policy the execution policy to use. See execution policy for details.
-/// @param input the input array.
-/// @param output the output array.
-/// @param f the unary function object which should return a type corresponding
-/// to the value_type of the output array.
-template <class ExecutionPolicy,
-          size_t N,
-          class ET1,
-          class ET2,
-          class UnaryFunction>
-static inline void transform(ExecutionPolicy&&               policy,
-                             const DistributedArray<N, ET1>& input,
-                             DistributedArray<N, ET2>&       output,
-                             UnaryFunction                   f) {
+///
+///@brief Creates a distributed array whose elements are generated from their
+/// global indices, i.e. element md_idx is set to generator(md_idx). Each
+/// process only evaluates its own boxes, so no process ever holds the global
+/// data. The boxes are initialized according to policy which also makes the
+/// first touch of the pages. The padding of the returned array is set to T{}.
+///
+///@tparam T the element type of the returned array
+///@param policy the execution policy to use. See execution policy for details.
+///@param topo the topology describing the distribution
+///@param rank the rank of the calling process in the topology
+///@param begin_padding padding used for the beginning of the local boxes
+///@param end_padding padding used for the end of the local boxes
+///@param generator function object returning the value of the element at the
+/// global index given as the argument
+///@return DistributedArray<N, T> the generated array
+///
+template <class T, class ExecutionPolicy, size_t N, class Generator>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+auto distribute(ExecutionPolicy&&         policy,
+                const Topology<N>&        topo,
+                int                       rank,
+                std::array<index_type, N> begin_padding,
+                std::array<index_type, N> end_padding,
+                Generator                 generator) {
 
-    const auto i_subspans = make_subspans(input);
-    const auto o_subspans = make_subspans(output);
+    DistributedArray<N, T> ret(policy, rank, topo, begin_padding, end_padding);
 
-    for (size_t i = 0; i < i_subspans.size(); ++i) {
-        auto i_span = i_subspans[i];
-        auto o_span = o_subspans[i];
-        transform(policy, i_span, o_span, f);
-    }
-}
+    for_each_indexed(
+        policy, ret, [=](auto md_idx, T& e) { e = generator(md_idx); });
 
-/// @brief Applies the given function f to every element of the input
-/// distributed array and stores the result in the output distributed array of
-/// same extent. Executed in order.
-/// @param input the input array.
-/// @param output the output array.
-/// @param f the unary function object which should return a type corresponding
-/// to the value_type of the output array.
-template <size_t N, class ET1, class ET2, class UnaryWindowFunction>
-static inline void transform(const DistributedArray<N, ET1>& input,
-                             DistributedArray<N, ET2>&       output,
-                             UnaryWindowFunction             f) {
+    return ret;
+}
 
-    transform(std::execution::seq, input, output, f);
+///
+///@brief Creates a distributed array whose elements are generated from their
+/// global indices. Executed in order.
+///
+///@tparam T the element type of the returned array
+///@param topo the topology describing the distribution
+///@param rank the rank of the calling process in the topology
+///@param begin_padding padding used for the beginning of the local boxes
+///@param end_padding padding used for the end of the local boxes
+///@param generator function object returning the value of the element at the
+/// global index given as the argument
+///@return DistributedArray<N, T> the generated array
+///
+template <class T, size_t N, class Generator>
+auto distribute(const Topology<N>&        topo,
+                int                       rank,
+                std::array<index_type, N> begin_padding,
+                std::array<index_type, N> end_padding,
+                Generator                 generator) {
+
+    return distribute<T>(std::execution::seq,
+                         topo,
+                         rank,
+                         begin_padding,
+                         end_padding,
+                         generator);
 }
 
-/// @brief Applies the given function f(global_md_idx, value) to every element
-/// of the distributed array and stores the result to the output distributed
-/// array of same extent. Note! The md_idx given to the function object f is the
-/// global index in the array topology. Executed according to policy (not
-/// necessarily in order).
-/// @param policy the execution policy to use. See execution policy for details.
-/// @param input the input array.
-/// @param output the output array.
-/// @param f the binary function object which should return a type corresponding
-/// to the value_type of output and take a current multidimensional index as the
-/// first argument.
-template <class ExecutionPolicy,
-          size_t N,
-          class ET1,
-          class ET2,
-          class UnaryWindowFunction>
-static inline void transform_indexed(ExecutionPolicy&&               policy,
-                                     const DistributedArray<N, ET1>& input,
-                                     DistributedArray<N, ET2>&       output,
-                                     UnaryWindowFunction             f) {
+namespace detail {
+
+///
+///@brief A partial result of a distributed reduction, which is empty on the
+/// processes without elements.
+///
+template <class T> struct PartialReduction {
+    T    value;
+    bool valid;
+};
 
-    const auto i_subspans = make_subspans(input);
-    const auto o_subspans = make_subspans(output);
-    const auto boxes      = input.get_local_boxes();
+///
+///@brief Applies the reduction operation Op to partial reductions skipping the
+/// empty ones.
+///
+template <class Op> struct PartialReductionOp {
 
-    for (size_t i = 0; i < i_subspans.size(); ++i) {
-        auto i_span = i_subspans[i];
-        auto o_span = o_subspans[i];
-        auto offset = boxes[i].box.begin;
-        auto F      = [=](auto md_idx) {
-            o_span(md_idx) = f(elementwise_add(md_idx, offset), i_span(md_idx));
-        };
+    Op op{};
 
-        detail::md_for_each(policy, all_indices(i_span), F);
+    template <class T>
+    constexpr PartialReduction<T>
+    operator()(const PartialReduction<T>& lhs,
+               const PartialReduction<T>& rhs) const {
+        if (!lhs.valid) { return rhs; }
+        if (!rhs.valid) { return lhs; }
+        return PartialReduction<T>{op(lhs.value, rhs.value), true};
     }
-}
-
-/// @brief Applies the given function f(global_md_idx, value) to every element
-/// of the distributed array and stores the result to the output distributed
-/// array of same extent. Note! The md_idx given to the function object f is the
-/// global index in the array topology. Executed in order.
-/// @param input the input array.
-/// @param output the output array.
-/// @param f the binary function object which should return a type corresponding
-/// to the value_type of output and take a current multidimensional index as the
-/// first argument.
-template <size_t N, class ET1, class ET2, class UnaryWindowFunction>
-static inline void transform_indexed(const DistributedArray<N, ET1>& input,
-                                     DistributedArray<N, ET2>&       output,
-                                     UnaryWindowFunction             f) {
+};
 
-    transform_indexed(std::execution::seq, input, output, f);
-}
+///
+///@brief A partial reduction of a tuple of values packed into a contiguous
+/// trivially copyable buffer, so that all the values are combined over the
+/// processes with a single mpi::all_reduce.
+///
+template <class... Ts> struct PackedPartialReduction {
+
+    std::array<std::byte, (sizeof(Ts) + ...)> values;
+    bool                                      valid;
+
+    static PackedPartialReduction
+    pack(const PartialReduction<std::tuple<Ts...>>& p) {
+        PackedPartialReduction ret{};
+        size_t                 offset = 0;
+        std::apply(
+            [&](const auto&... v) {
+                ((std::memcpy(ret.values.data() + offset, &v, sizeof(v)),
+                  offset += sizeof(v)),
+                 ...);
+            },
+            p.value);
+        ret.valid = p.valid;
+        return ret;
+    }
 
-/// @brief Applies the input unary window function to all elements of the input
+    PartialReduction<std::tuple<Ts...>> unpack() const {
+        PartialReduction<std::tuple<Ts...>> ret{{}, valid};
+        size_t                              offset = 0;
+        std::apply(
+            [&](auto&... v) {
+                ((std::memcpy(&v, values.data() + offset, sizeof(v)),
+                  offset += sizeof(v)),
+                 ...);
+            },
+            ret.value);
+        return ret;
+    }
+};
+
+///
+///@brief Applies the reduction operation Op to packed partial reductions.
+///
+template <class Op> struct PackedPartialReductionOp {
+
+    PartialReductionOp<Op> op{};
+
+    template <class Packed>
+    Packed operator()(const Packed& lhs, const Packed& rhs) const {
+        return Packed::pack(op(lhs.unpack(), rhs.unpack()));
+    }
+};
+
+///
+///@brief Combines the partial reductions of all processes.
+///
+template <class T, class Op>
+static inline PartialReduction<T>
+all_reduce_partial(const PartialReduction<T>& local,
+                   PartialReductionOp<Op>     op) {
+    return mpi::all_reduce(local, op);
+}
+
+///
+///@brief Combines the partial reductions of tuples of all processes, the
+/// tuples are packed into contiguous buffers to be reduced at once.
+///
+template <class... Ts, class Op>
+static inline PartialReduction<std::tuple<Ts...>>
+all_reduce_partial(const PartialReduction<std::tuple<Ts...>>& local,
+                   PartialReductionOp<Op>) {
+    using packed = PackedPartialReduction<Ts...>;
+    return mpi::all_reduce(packed::pack(local), PackedPartialReductionOp<Op>{})
+        .unpack();
+}
+
+///
+///@brief Reduces f(global_md_idx, value) over the local elements of the array
+/// and combines the local results of all processes with mpi::all_reduce. The
+/// initial value is applied once.
+///
+template <class ExecutionPolicy,
+          size_t N,
+          class ET,
+          class A,
+          class T,
+          class BinaryReductionOp,
+          class BinaryIndexFunction>
+static inline T distributed_reduce(ExecutionPolicy&&                 policy,
+                                   const DistributedArray<N, ET, A>& arr,
+                                   T                                 init,
+                                   BinaryReductionOp                 reduce,
+                                   BinaryIndexFunction               f) {
+
+    using partial = PartialReduction<T>;
+
+    const PartialReductionOp<BinaryReductionOp> op{reduce};
+
+    partial local{init, false};
+    {
+        ScopedTimer timer(Phase::Kernel);
+
+        const auto& boxes    = arr.get_local_boxes();
+        const auto& subspans = make_subspans(arr);
+        for (size_t i = 0; i < subspans.size(); ++i) {
+            auto span   = subspans[i];
+            auto offset = boxes[i].box.begin;
+            local       = op(local,
+                       detail::md_transform_reduce(
+                           policy,
+                           std::array<index_type, N>{},
+                           detail::index_extent(span),
+                           partial{init, false},
+                           op,
+                           [=](auto md_idx) {
+                               return partial{
+                                   T(f(jada::elementwise_add(md_idx, offset),
+                                       span(md_idx))),
+                                   true};
+                           }));
+        }
+    }
+
+    const auto global = all_reduce_partial(local, op);
+    return global.valid ? reduce(init, global.value) : init;
+}
+
+} // namespace detail
+
+/// @brief Applies the transform function to every element of the array and
+/// reduces the results with the binary reduction operation starting from init.
+/// The padding is not visited. The local results are combined over all
+/// processes with mpi::all_reduce, so the function has to be called by all
+/// processes and all of them get the same result. Executed according to policy
+/// (not necessarily in order), so the reduction should be associative and
+/// commutative. Example: the squared l2 norm is
+/// transform_reduce(policy, arr, 0.0, std::plus<>{}, [](auto v){return v*v;}).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param arr the input array.
+/// @param init the initial value of the reduction.
+/// @param reduce the binary reduction operation, has to be stateless.
+/// @param transform the unary function applied to each element before the
+/// reduction.
+/// @return T the result of the reduction.
+template <class ExecutionPolicy,
+          size_t N,
+          class ET,
+          class A,
+          class T,
+          class BinaryReductionOp,
+          class UnaryTransformOp>
+static inline T transform_reduce(ExecutionPolicy&&                 policy,
+                                 const DistributedArray<N, ET, A>& arr,
+                                 T                                 init,
+                                 BinaryReductionOp                 reduce,
+                                 UnaryTransformOp                  transform) {
+
+    return detail::distributed_reduce(
+        policy, arr, init, reduce, [=](auto, const auto& v) {
+            return transform(v);
+        });
+}
+
+/// @brief Applies the transform function to every element of the array and
+/// reduces the results with the binary reduction operation starting from init.
+/// Executed in order.
+/// @param arr the input array.
+/// @param init the initial value of the reduction.
+/// @param reduce the binary reduction operation, has to be stateless.
+/// @param transform the unary function applied to each element before the
+/// reduction.
+/// @return T the result of the reduction.
+template <size_t N,
+          class ET,
+          class A,
+          class T,
+          class BinaryReductionOp,
+          class UnaryTransformOp>
+static inline T transform_reduce(const DistributedArray<N, ET, A>& arr,
+                                 T                                 init,
+                                 BinaryReductionOp                 reduce,
+                                 UnaryTransformOp                  transform) {
+
+    return transform_reduce(std::execution::seq, arr, init, reduce, transform);
+}
+
+/// @brief Applies the function f(global_md_idx, value) to every element of the
+/// array and reduces the results with the binary reduction operation starting
+/// from init. Note! The md_idx given to the function object f is the global
+/// index in the array topology. Executed according to policy (not necessarily
+/// in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param arr the input array.
+/// @param init the initial value of the reduction.
+/// @param reduce the binary reduction operation, has to be stateless.
+/// @param f the binary function taking the current (global) multidimensional
+/// index as the first argument and the element as the second one.
+/// @return T the result of the reduction.
+template <class ExecutionPolicy,
+          size_t N,
+          class ET,
+          class A,
+          class T,
+          class BinaryReductionOp,
+          class BinaryIndexFunction>
+static inline T
+transform_reduce_indexed(ExecutionPolicy&&                 policy,
+                         const DistributedArray<N, ET, A>& arr,
+                         T                                 init,
+                         BinaryReductionOp                 reduce,
+                         BinaryIndexFunction               f) {
+
+    return detail::distributed_reduce(policy, arr, init, reduce, f);
+}
+
+/// @brief Applies the function f(global_md_idx, value) to every element of the
+/// array and reduces the results with the binary reduction operation starting
+/// from init. Executed in order.
+/// @param arr the input array.
+/// @param init the initial value of the reduction.
+/// @param reduce the binary reduction operation, has to be stateless.
+/// @param f the binary function taking the current (global) multidimensional
+/// index as the first argument and the element as the second one.
+/// @return T the result of the reduction.
+template <size_t N,
+          class ET,
+          class A,
+          class T,
+          class BinaryReductionOp,
+          class BinaryIndexFunction>
+static inline T
+transform_reduce_indexed(const DistributedArray<N, ET, A>& arr,
+                         T                                 init,
+                         BinaryReductionOp                 reduce,
+                         BinaryIndexFunction               f) {
+
+    return transform_reduce_indexed(
+        std::execution::seq, arr, init, reduce, f);
+}
+
+/// @brief Reduces all elements of the array with the binary reduction
+/// operation starting from init over all processes. Executed according to
+/// policy (not necessarily in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param arr the input array.
+/// @param init the initial value of the reduction.
+/// @param op the binary reduction operation (defaults to addition), has to be
+/// stateless.
+/// @return T the result of the reduction.
+template <class ExecutionPolicy,
+          size_t N,
+          class ET,
+          class A,
+          class T,
+          class BinaryReductionOp = std::plus<>>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+static inline T reduce(ExecutionPolicy&&                 policy,
+                       const DistributedArray<N, ET, A>& arr,
+                       T                                 init,
+                       BinaryReductionOp                 op = {}) {
+
+    return transform_reduce(policy, arr, init, op, Identity{});
+}
+
+/// @brief Reduces all elements of the array with the binary reduction
+/// operation starting from init over all processes. Executed in order.
+/// @param arr the input array.
+/// @param init the initial value of the reduction.
+/// @param op the binary reduction operation (defaults to addition), has to be
+/// stateless.
+/// @return T the result of the reduction.
+template <size_t N,
+          class ET,
+          class A,
+          class T,
+          class BinaryReductionOp = std::plus<>>
+static inline T reduce(const DistributedArray<N, ET, A>& arr,
+                       T                                 init,
+                       BinaryReductionOp                 op = {}) {
+
+    return reduce(std::execution::seq, arr, init, op);
+}
+
+/// @brief Computes several reductions of the elements of the array in a single
+/// traversal and combines the local results of all of them over all processes
+/// with a single mpi::all_reduce, see multi_reduce for spans. The reduction
+/// operations have to be stateless. Executed according to policy (not
+/// necessarily in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param arr the input array.
+/// @param reducers the reductions to compute, see make_reducer.
+/// @return std::tuple of the results of the reducers in the given order.
+template <class ExecutionPolicy, size_t N, class ET, class A, class... Reducers>
+    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+static inline auto multi_reduce(ExecutionPolicy&&                 policy,
+                                const DistributedArray<N, ET, A>& arr,
+                                Reducers...                       reducers) {
+
+    static_assert(sizeof...(Reducers) > 0, "No reducers given to multi_reduce");
+
+    const auto transform = detail::tuple_transform(reducers...);
+
+    return detail::distributed_reduce(
+        policy,
+        arr,
+        std::make_tuple(reducers.init...),
+        detail::tuple_reduction_op(reducers...),
+        [=](auto, const auto& v) { return transform(v); });
+}
+
+/// @brief Computes several reductions of the elements of the array in a single
+/// traversal and combines them over all processes with a single
+/// mpi::all_reduce. Executed in order.
+/// @param arr the input array.
+/// @param reducers the reductions to compute, see make_reducer.
+/// @return std::tuple of the results of the reducers in the given order.
+template <size_t N, class ET, class A, class... Reducers>
+static inline auto multi_reduce(const DistributedArray<N, ET, A>& arr,
+                                Reducers...                       reducers) {
+
+    return multi_reduce(std::execution::seq, arr, reducers...);
+}
+
+/// @brief Applies the given function to every element (not necessarily in
+/// order) of the input distributed array and stores the result in the output
+/// distributed array of same extent. Executed according to policy (not
+/// necessarily in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param input the input array.
+/// @param output the output array.
+/// @param f the unary function object which should return a type corresponding
+/// to the value_type of the output array.
+template <class ExecutionPolicy,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryFunction>
+static inline void transform(ExecutionPolicy&&                   policy,
+                             const DistributedArray<N, ET1, A1>& input,
+                             DistributedArray<N, ET2, A2>&       output,
+                             UnaryFunction                       f) {
+
+    ScopedTimer timer(Phase::Kernel);
+
+    const auto& i_subspans = make_subspans(input);
+    const auto& o_subspans = make_subspans(output);
+
+    for (size_t i = 0; i < i_subspans.size(); ++i) {
+        auto i_span = i_subspans[i];
+        auto o_span = o_subspans[i];
+        transform(policy, i_span, o_span, f);
+    }
+}
+
+/// @brief Applies the given function f to every element of the input
+/// distributed array and stores the result in the output distributed array of
+/// same extent. Executed in order.
+/// @param input the input array.
+/// @param output the output array.
+/// @param f the unary function object which should return a type corresponding
+/// to the value_type of the output array.
+template <size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryWindowFunction>
+static inline void transform(const DistributedArray<N, ET1, A1>& input,
+                             DistributedArray<N, ET2, A2>&       output,
+                             UnaryWindowFunction                 f) {
+
+    transform(std::execution::seq, input, output, f);
+}
+
+/// @brief Applies the given function f(global_md_idx, value) to every element
+/// of the distributed array and stores the result to the output distributed
+/// array of same extent. Note! The md_idx given to the function object f is the
+/// global index in the array topology. Executed according to policy (not
+/// necessarily in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param input the input array.
+/// @param output the output array.
+/// @param f the binary function object which should return a type corresponding
+/// to the value_type of output and take a current multidimensional index as the
+/// first argument.
+template <class ExecutionPolicy,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryWindowFunction>
+static inline void transform_indexed(ExecutionPolicy&&                   policy,
+                                     const DistributedArray<N, ET1, A1>& input,
+                                     DistributedArray<N, ET2, A2>&       output,
+                                     UnaryWindowFunction                 f) {
+
+    ScopedTimer timer(Phase::Kernel);
+
+    const auto& i_subspans = make_subspans(input);
+    const auto& o_subspans = make_subspans(output);
+    const auto& boxes      = input.get_local_boxes();
+
+    for (size_t i = 0; i < i_subspans.size(); ++i) {
+        auto i_span = i_subspans[i];
+        auto o_span = o_subspans[i];
+        auto offset = boxes[i].box.begin;
+        auto F      = [=](auto md_idx) {
+            o_span(md_idx) = f(elementwise_add(md_idx, offset), i_span(md_idx));
+        };
+
+        detail::md_for_each(policy, all_indices(i_span), F);
+    }
+}
+
+/// @brief Applies the given function f(global_md_idx, value) to every element
+/// of the distributed array and stores the result to the output distributed
+/// array of same extent. Note! The md_idx given to the function object f is the
+/// global index in the array topology. Executed in order.
+/// @param input the input array.
+/// @param output the output array.
+/// @param f the binary function object which should return a type corresponding
+/// to the value_type of output and take a current multidimensional index as the
+/// first argument.
+template <size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryWindowFunction>
+static inline void transform_indexed(const DistributedArray<N, ET1, A1>& input,
+                                     DistributedArray<N, ET2, A2>&       output,
+                                     UnaryWindowFunction                 f) {
+
+    transform_indexed(std::execution::seq, input, output, f);
+}
+
+/// @brief Applies the input unary window function to all elements of the input
 /// array and stores the result into the output array. A window accessor has the
 /// same rank as the distributed arrays. Executed according to policy (not
 /// necessarily in order).
@@ -505,15 +1421,19 @@ static inline void transform_indexed(const DistributedArray<N, ET1>& input,
 template <class ExecutionPolicy,
           size_t N,
           class ET1,
+          class A1,
           class ET2,
+          class A2,
           class UnaryWindowFunction>
-static inline void window_transform(ExecutionPolicy&&               policy,
-                                    const DistributedArray<N, ET1>& input,
-                                    DistributedArray<N, ET2>&       output,
-                                    UnaryWindowFunction             f) {
+static inline void window_transform(ExecutionPolicy&&                   policy,
+                                    const DistributedArray<N, ET1, A1>& input,
+                                    DistributedArray<N, ET2, A2>&       output,
+                                    UnaryWindowFunction                 f) {
 
-    const auto i_subspans = make_subspans(input);
-    const auto o_subspans = make_subspans(output);
+    ScopedTimer timer(Phase::Kernel);
+
+    const auto& i_subspans = make_subspans(input);
+    const auto& o_subspans = make_subspans(output);
 
     for (size_t i = 0; i < i_subspans.size(); ++i) {
         auto i_span = i_subspans[i];
@@ -522,6 +1442,39 @@ static inline void window_transform(ExecutionPolicy&&               policy,
     }
 }
 
+/// @brief Applies the input unary window function to all elements of the input
+/// array and stores the result into the output array traversing each local
+/// block in cache blocks. A window accessor has the same rank as the
+/// distributed arrays. Executed according to policy (not necessarily in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param input the input array.
+/// @param output the output array.
+/// @param f the unary window operation.
+/// @param traversal the block sizes, zero sizes are chosen automatically.
+template <class ExecutionPolicy,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryWindowFunction>
+static inline void
+window_transform(ExecutionPolicy&&                   policy,
+                 const DistributedArray<N, ET1, A1>& input,
+                 DistributedArray<N, ET2, A2>&       output,
+                 UnaryWindowFunction                 f,
+                 Blocked<N>                          traversal) {
+
+    ScopedTimer timer(Phase::Kernel);
+
+    const auto& i_subspans = make_subspans(input);
+    const auto& o_subspans = make_subspans(output);
+
+    for (size_t i = 0; i < i_subspans.size(); ++i) {
+        window_transform(policy, i_subspans[i], o_subspans[i], f, traversal);
+    }
+}
+
 /// @brief Applies the input unary window function to all elements of the input
 /// array and stores the result into the output array. A window accessor has the
 /// same rank as the distributed arrays. Executed in order.
@@ -529,10 +1482,15 @@ static inline void window_transform(ExecutionPolicy&&               policy,
 /// @param output the output array.
 /// @param f the unary window operation. Example: f = [](auto accessor){return
 /// accessor(1,0) + accessor(-1,0);};
-template <size_t N, class ET1, class ET2, class UnaryWindowFunction>
-static inline void window_transform(const DistributedArray<N, ET1>& input,
-                                    DistributedArray<N, ET2>&       output,
-                                    UnaryWindowFunction             f) {
+template <size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryWindowFunction>
+static inline void window_transform(const DistributedArray<N, ET1, A1>& input,
+                                    DistributedArray<N, ET2, A2>&       output,
+                                    UnaryWindowFunction                 f) {
 
     window_transform(std::execution::seq, input, output, f);
 }
@@ -550,15 +1508,19 @@ template <size_t Dir,
           class ExecutionPolicy,
           size_t N,
           class ET1,
+          class A1,
           class ET2,
+          class A2,
           class UnaryTileFunction>
-static inline void tile_transform(ExecutionPolicy&&               policy,
-                                  const DistributedArray<N, ET1>& input,
-                                  DistributedArray<N, ET2>&       output,
-                                  UnaryTileFunction               f) {
+static inline void tile_transform(ExecutionPolicy&&                   policy,
+                                  const DistributedArray<N, ET1, A1>& input,
+                                  DistributedArray<N, ET2, A2>&       output,
+                                  UnaryTileFunction                   f) {
+
+    ScopedTimer timer(Phase::Kernel);
 
-    const auto i_subspans = make_subspans(input);
-    const auto o_subspans = make_subspans(output);
+    const auto& i_subspans = make_subspans(input);
+    const auto& o_subspans = make_subspans(output);
 
     for (size_t i = 0; i < i_subspans.size(); ++i) {
         auto i_span = i_subspans[i];
@@ -568,6 +1530,42 @@ static inline void tile_transform(ExecutionPolicy&&               policy,
     }
 }
 
+/// @brief Applies the input unary tile function f to all elements of the input
+/// array and stores the result into the output array traversing each local
+/// block in cache blocks. A tile accessor is one dimensional. Executed
+/// according to policy (not necessarily in order).
+/// @tparam Dir the direction (index) along which the tile is created.
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param input the input array.
+/// @param output the output array.
+/// @param f the unary tile operation.
+/// @param traversal the block sizes, zero sizes are chosen automatically.
+template <size_t Dir,
+          class ExecutionPolicy,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryTileFunction>
+static inline void
+tile_transform(ExecutionPolicy&&                   policy,
+               const DistributedArray<N, ET1, A1>& input,
+               DistributedArray<N, ET2, A2>&       output,
+               UnaryTileFunction                   f,
+               Blocked<N>                          traversal) {
+
+    ScopedTimer timer(Phase::Kernel);
+
+    const auto& i_subspans = make_subspans(input);
+    const auto& o_subspans = make_subspans(output);
+
+    for (size_t i = 0; i < i_subspans.size(); ++i) {
+        tile_transform<Dir>(
+            policy, i_subspans[i], o_subspans[i], f, traversal);
+    }
+}
+
 /// @brief Applies the input unary tile function f to all elements of the input
 /// array and stores the result into the output array. A tile accessor is one
 /// dimensional. Executed in order.
@@ -576,22 +1574,209 @@ static inline void tile_transform(ExecutionPolicy&&               policy,
 /// @param output the output array.
 /// @param f the unary tile operation. Example: f = [](auto accessor){return
 /// accessor(0) + accessor(1);};
-template <size_t Dir, size_t N, class ET1, class ET2, class UnaryTileFunction>
-static inline void tile_transform(const DistributedArray<N, ET1>& input,
-                                  DistributedArray<N, ET2>&       output,
-                                  UnaryTileFunction               f) {
+template <size_t Dir,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryTileFunction>
+static inline void tile_transform(const DistributedArray<N, ET1, A1>& input,
+                                  DistributedArray<N, ET2, A2>&       output,
+                                  UnaryTileFunction                   f) {
 
     tile_transform<Dir>(std::execution::seq, input, output, f);
 }
 
-template <class ExecutionPolicy, size_t N, class ET, class UnaryIndexFunction>
-static inline void for_each_boundary(ExecutionPolicy&&         policy,
-                                     DistributedArray<N, ET>&  arr,
-                                     std::array<index_type, N> dir,
-                                     UnaryIndexFunction        f) {
+/// @brief Applies the input unary tile function f to all elements of the input
+/// array and stores the result into the output array evaluating f for several
+/// consecutive elements of the innermost direction at once, see
+/// simd_tile_transform for spans. Executed according to policy (not
+/// necessarily in order).
+/// @tparam Dir the direction (index) along which the tile is created.
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param input the input array.
+/// @param output the output array.
+/// @param f the unary tile operation using only arithmetic operators.
+template <size_t Dir,
+          class ExecutionPolicy,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryTileFunction>
+static inline void
+simd_tile_transform(ExecutionPolicy&&                   policy,
+                    const DistributedArray<N, ET1, A1>& input,
+                    DistributedArray<N, ET2, A2>&       output,
+                    UnaryTileFunction                   f) {
+
+    ScopedTimer timer(Phase::Kernel);
+
+    const auto& i_subspans = make_subspans(input);
+    const auto& o_subspans = make_subspans(output);
 
-    const auto boxes    = arr.get_local_boxes();
-    const auto subspans = make_subspans(arr);
+    for (size_t i = 0; i < i_subspans.size(); ++i) {
+        simd_tile_transform<Dir>(policy, i_subspans[i], o_subspans[i], f);
+    }
+}
+
+/// @brief Applies the input unary tile function f to all elements of the input
+/// array and stores the result into the output array evaluating f for several
+/// consecutive elements of the innermost direction at once. Executed in order.
+/// @tparam Dir the direction (index) along which the tile is created.
+/// @param input the input array.
+/// @param output the output array.
+/// @param f the unary tile operation using only arithmetic operators.
+template <size_t Dir,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryTileFunction>
+static inline void
+simd_tile_transform(const DistributedArray<N, ET1, A1>& input,
+                    DistributedArray<N, ET2, A2>&       output,
+                    UnaryTileFunction                   f) {
+
+    simd_tile_transform<Dir>(std::execution::seq, input, output, f);
+}
+
+/// @brief Applies the compile-time stencil S to all elements of the input array
+/// and stores scale times the result into the output array, see
+/// stencil_transform for spans. The padding of the input array is validated
+/// against the reach of S. Executed according to policy (not necessarily in
+/// order).
+/// @tparam S the stencil, see Stencil.
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param input the input array.
+/// @param output the output array.
+/// @param scale a runtime factor multiplying the result.
+template <auto S,
+          class ExecutionPolicy,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class Scale = double>
+static inline void
+stencil_transform(ExecutionPolicy&&                   policy,
+                  const DistributedArray<N, ET1, A1>& input,
+                  DistributedArray<N, ET2, A2>&       output,
+                  Scale                               scale = Scale(1)) {
+
+    static_assert(decltype(S)::rank() == N, "Rank mismatch in stencil");
+
+    constexpr auto bpad = S.begin_padding();
+    constexpr auto epad = S.end_padding();
+    for (size_t i = 0; i < N; ++i) {
+        runtime_assert(bpad[i] <= input.get_begin_padding()[i] &&
+                           epad[i] <= input.get_end_padding()[i],
+                       "Stencil reach exceeds the padding");
+    }
+
+    ScopedTimer timer(Phase::Kernel);
+
+    const auto& i_subspans = make_subspans(input);
+    const auto& o_subspans = make_subspans(output);
+
+    for (size_t i = 0; i < i_subspans.size(); ++i) {
+        stencil_transform<S>(policy, i_subspans[i], o_subspans[i], scale);
+    }
+}
+
+/// @brief Applies the compile-time stencil S to all elements of the input array
+/// and stores scale times the result into the output array. Executed in order.
+/// @tparam S the stencil, see Stencil.
+/// @param input the input array.
+/// @param output the output array.
+/// @param scale a runtime factor multiplying the result.
+template <auto S,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class Scale = double>
+static inline void
+stencil_transform(const DistributedArray<N, ET1, A1>& input,
+                  DistributedArray<N, ET2, A2>&       output,
+                  Scale                               scale = Scale(1)) {
+
+    stencil_transform<S>(std::execution::seq, input, output, scale);
+}
+
+/// @brief Evaluates all the input window and tile terms at every element of the
+/// input array and stores the result of combining them into the output array
+/// in a single traversal, see fused_transform for spans. Executed according to
+/// policy (not necessarily in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param input the input array.
+/// @param output the output array.
+/// @param combiner function object taking the values of all the terms.
+/// @param terms the window_term and tile_term operations to evaluate.
+template <class ExecutionPolicy,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class Combiner,
+          class... Terms>
+static inline void fused_transform(ExecutionPolicy&&                   policy,
+                                   const DistributedArray<N, ET1, A1>& input,
+                                   DistributedArray<N, ET2, A2>&       output,
+                                   Combiner                            combiner,
+                                   Terms...                            terms) {
+
+    ScopedTimer timer(Phase::Kernel);
+
+    const auto& i_subspans = make_subspans(input);
+    const auto& o_subspans = make_subspans(output);
+
+    for (size_t i = 0; i < i_subspans.size(); ++i) {
+        fused_transform(
+            policy, i_subspans[i], o_subspans[i], combiner, terms...);
+    }
+}
+
+/// @brief Evaluates all the input window and tile terms at every element of the
+/// input array and stores the result of combining them into the output array
+/// in a single traversal. Executed in order.
+/// @param input the input array.
+/// @param output the output array.
+/// @param combiner function object taking the values of all the terms.
+/// @param terms the window_term and tile_term operations to evaluate.
+template <size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class Combiner,
+          class... Terms>
+static inline void fused_transform(const DistributedArray<N, ET1, A1>& input,
+                                   DistributedArray<N, ET2, A2>&       output,
+                                   Combiner                            combiner,
+                                   Terms...                            terms) {
+
+    fused_transform(std::execution::seq, input, output, combiner, terms...);
+}
+
+template <class ExecutionPolicy,
+          size_t N,
+          class ET,
+          class A,
+          class UnaryIndexFunction>
+static inline void for_each_boundary(ExecutionPolicy&&           policy,
+                                     DistributedArray<N, ET, A>& arr,
+                                     std::array<index_type, N>   dir,
+                                     UnaryIndexFunction          f) {
+
+    const auto& boxes    = arr.get_local_boxes();
+    const auto& subspans = make_subspans(arr);
     const auto topo     = arr.topology();
     for (size_t i = 0; i < subspans.size(); ++i) {
         auto span = subspans[i];
@@ -605,21 +1790,25 @@ static inline void for_each_boundary(ExecutionPolicy&&         policy,
     }
 }
 
-template <size_t N, class ET, class UnaryIndexFunction>
-static inline void for_each_boundary(DistributedArray<N, ET>&  arr,
-                                     std::array<index_type, N> dir,
-                                     UnaryIndexFunction        f) {
+template <size_t N, class ET, class A, class UnaryIndexFunction>
+static inline void for_each_boundary(DistributedArray<N, ET, A>& arr,
+                                     std::array<index_type, N>   dir,
+                                     UnaryIndexFunction          f) {
     for_each_boundary(std::execution::par_unseq, arr, dir, f);
 }
 
-template <class ExecutionPolicy, size_t N, class ET, class BinaryIndexFunction>
-static inline void for_each_indexed_boundary(ExecutionPolicy&&         policy,
-                                             DistributedArray<N, ET>&  arr,
-                                             std::array<index_type, N> dir,
-                                             BinaryIndexFunction       f) {
-
-    const auto boxes    = arr.get_local_boxes();
-    const auto subspans = make_subspans(arr);
+template <class ExecutionPolicy,
+          size_t N,
+          class ET,
+          class A,
+          class BinaryIndexFunction>
+static inline void for_each_indexed_boundary(ExecutionPolicy&&           policy,
+                                             DistributedArray<N, ET, A>& arr,
+                                             std::array<index_type, N>   dir,
+                                             BinaryIndexFunction         f) {
+
+    const auto& boxes    = arr.get_local_boxes();
+    const auto& subspans = make_subspans(arr);
     const auto topo     = arr.topology();
     for (size_t i = 0; i < subspans.size(); ++i) {
         auto       span   = subspans[i];
@@ -640,20 +1829,22 @@ static inline void for_each_indexed_boundary(ExecutionPolicy&&         policy,
 template <class ExecutionPolicy,
           size_t N,
           class ET1,
+          class A1,
           class ET2,
+          class A2,
           class UnaryTileFunction>
 static inline void
-tile_transform_boundary(ExecutionPolicy&&               policy,
-                        const DistributedArray<N, ET1>& input,
-                        DistributedArray<N, ET2>&       output,
-                        std::array<index_type, N>       dir,
-                        UnaryTileFunction               f)
+tile_transform_boundary(ExecutionPolicy&&                   policy,
+                        const DistributedArray<N, ET1, A1>& input,
+                        DistributedArray<N, ET2, A2>&       output,
+                        std::array<index_type, N>           dir,
+                        UnaryTileFunction                   f)
 
 {
 
-    const auto i_subspans = make_subspans(input);
-    const auto o_subspans = make_subspans(output);
-    const auto boxes = input.get_local_boxes();
+    const auto& i_subspans = make_subspans(input);
+    const auto& o_subspans = make_subspans(output);
+    const auto& boxes      = input.get_local_boxes();
 
     for (size_t i = 0; i < i_subspans.size(); ++i) {
         auto i_span = i_subspans[i];
@@ -673,6 +1864,451 @@ tile_transform_boundary(ExecutionPolicy&&               policy,
     }
 }
 
+namespace detail {
+
+///
+///@brief Returns the region of a block of extent 'dims' which can be computed
+/// without data from the padding by a stencil accessing offsets [min, max].
+///
+///@param dims the unpadded extent of the block
+///@param min the minimum offsets accessed by the stencil
+///@param max the maximum offsets accessed by the stencil
+///@return Box<N> the interior region in local (unpadded) indices
+///
+template <size_t N>
+static inline Box<N> interior_region(std::array<size_type, N>  dims,
+                                     std::array<index_type, N> min,
+                                     std::array<index_type, N> max) {
+
+    Box<N> ret;
+    for (size_t i = 0; i < N; ++i) {
+        const auto n = index_type(dims[i]);
+        ret.begin[i] = std::min(std::max(index_type(0), -min[i]), n);
+        ret.end[i] =
+            std::max(ret.begin[i], n - std::max(index_type(0), max[i]));
+    }
+    return ret;
+}
+
+///
+///@brief Starts a halo exchange of the input array, applies 'kernel' to the
+/// interior regions of all local blocks which do not depend on the padding,
+/// waits for the exchange to complete and finally applies 'kernel' to the
+/// remaining boundary shells of the blocks. The packing and unpacking of the
+/// exchange are executed according to policy.
+///
+///@param policy the execution policy of the exchange
+///@param input the input array whose padding is exchanged
+///@param output the output array
+///@param min the minimum offsets accessed by the stencil
+///@param max the maximum offsets accessed by the stencil
+///@param kernel function object kernel(i_subspan, o_subspan) evaluating the
+/// stencil on a region of a block
+///
+template <class ExecutionPolicy,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class Kernel>
+static inline void exchange_and_compute(ExecutionPolicy&&             policy,
+                                        DistributedArray<N, ET1, A1>& input,
+                                        DistributedArray<N, ET2, A2>& output,
+                                        std::array<index_type, N>     min,
+                                        std::array<index_type, N>     max,
+                                        Kernel                        kernel) {
+
+    const auto bpad = input.get_begin_padding();
+    const auto epad = input.get_end_padding();
+    for (size_t i = 0; i < N; ++i) {
+        runtime_assert(-min[i] <= bpad[i] && max[i] <= epad[i],
+                       "Stencil reach exceeds the padding");
+    }
+
+    auto handle = mpi_send_receive_async(policy, input);
+
+    const auto& i_subspans = make_subspans(std::as_const(input));
+    const auto& o_subspans = make_subspans(output);
+
+    std::vector<Box<N>> wholes;
+    std::vector<Box<N>> interiors;
+
+    for (size_t i = 0; i < i_subspans.size(); ++i) {
+        const auto dims = dimensions(i_subspans[i]);
+
+        Box<N> whole{};
+        for (size_t j = 0; j < N; ++j) { whole.end[j] = index_type(dims[j]); }
+
+        wholes.push_back(whole);
+        interiors.push_back(interior_region(dims, min, max));
+
+        const auto& in = interiors.back();
+        ScopedTimer timer(Phase::Kernel);
+        kernel(make_subspan(i_subspans[i], in.begin, in.end),
+               make_subspan(o_subspans[i], in.begin, in.end));
+    }
+
+    handle.wait(policy);
+
+    ScopedTimer timer(Phase::Kernel);
+    for (size_t i = 0; i < i_subspans.size(); ++i) {
+        for (const auto& shell : difference(wholes[i], interiors[i])) {
+            kernel(make_subspan(i_subspans[i], shell.begin, shell.end),
+                   make_subspan(o_subspans[i], shell.begin, shell.end));
+        }
+    }
+}
+
+} // namespace detail
+
+/// @brief Exchanges the padding of the input array and applies the input unary
+/// window function to all elements of the input array storing the result into
+/// the output array. The elements which do not depend on the padding are
+/// computed while the exchange is in progress. A window accessor has the same
+/// rank as the distributed arrays. Executed according to policy (not
+/// necessarily in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param input the input array whose padding is exchanged.
+/// @param output the output array.
+/// @param f the unary window operation. Example: f = [](auto accessor){return
+/// accessor(1,0) + accessor(-1,0);};
+template <class ExecutionPolicy,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryWindowFunction>
+static inline void
+exchange_window_transform(ExecutionPolicy&&             policy,
+                          DistributedArray<N, ET1, A1>& input,
+                          DistributedArray<N, ET2, A2>& output,
+                          UnaryWindowFunction           f) {
+
+    const auto [min, max] = md_min_max_offset<N>(f);
+
+    auto kernel = [&](auto i_span, auto o_span) {
+        window_transform(policy, i_span, o_span, f);
+    };
 
+    detail::exchange_and_compute(policy, input, output, min, max, kernel);
+}
+
+/// @brief Exchanges the padding of the input array and applies the input unary
+/// window function to all elements of the input array storing the result into
+/// the output array. Executed in order.
+/// @param input the input array whose padding is exchanged.
+/// @param output the output array.
+/// @param f the unary window operation. Example: f = [](auto accessor){return
+/// accessor(1,0) + accessor(-1,0);};
+template <size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryWindowFunction>
+static inline void
+exchange_window_transform(DistributedArray<N, ET1, A1>& input,
+                          DistributedArray<N, ET2, A2>& output,
+                          UnaryWindowFunction           f) {
+
+    exchange_window_transform(std::execution::seq, input, output, f);
+}
+
+/// @brief Exchanges the padding of the input array and applies the compile-time
+/// stencil S to all elements of the input array, storing scale times the
+/// result into the output array. The elements which do not depend on the
+/// padding are computed while the exchange is in progress. Executed according
+/// to policy (not necessarily in order).
+/// @tparam S the stencil, see Stencil.
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param input the input array whose padding is exchanged.
+/// @param output the output array.
+/// @param scale a runtime factor multiplying the result.
+template <auto S,
+          class ExecutionPolicy,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class Scale = double>
+static inline void
+exchange_stencil_transform(ExecutionPolicy&&             policy,
+                           DistributedArray<N, ET1, A1>& input,
+                           DistributedArray<N, ET2, A2>& output,
+                           Scale                         scale = Scale(1)) {
+
+    static_assert(decltype(S)::rank() == N, "Rank mismatch in stencil");
+
+    auto kernel = [&](auto i_span, auto o_span) {
+        stencil_transform<S>(policy, i_span, o_span, scale);
+    };
+
+    detail::exchange_and_compute(
+        policy, input, output, S.min(), S.max(), kernel);
+}
+
+/// @brief Exchanges the padding of the input array and applies the compile-time
+/// stencil S to all elements of the input array, storing scale times the
+/// result into the output array. Executed in order.
+/// @tparam S the stencil, see Stencil.
+/// @param input the input array whose padding is exchanged.
+/// @param output the output array.
+/// @param scale a runtime factor multiplying the result.
+template <auto S,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class Scale = double>
+static inline void
+exchange_stencil_transform(DistributedArray<N, ET1, A1>& input,
+                           DistributedArray<N, ET2, A2>& output,
+                           Scale                         scale = Scale(1)) {
+
+    exchange_stencil_transform<S>(std::execution::seq, input, output, scale);
+}
+
+/// @brief Exchanges the padding of the input array and evaluates all the input
+/// window and tile terms at every element of the input array, storing the
+/// result of combining them into the output array in a single traversal. The
+/// elements which do not depend on the padding are computed while the exchange
+/// is in progress. Executed according to policy (not necessarily in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param input the input array whose padding is exchanged.
+/// @param output the output array.
+/// @param combiner function object taking the values of all the terms.
+/// @param terms the window_term and tile_term operations to evaluate.
+template <class ExecutionPolicy,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class Combiner,
+          class... Terms>
+static inline void
+exchange_fused_transform(ExecutionPolicy&&             policy,
+                         DistributedArray<N, ET1, A1>& input,
+                         DistributedArray<N, ET2, A2>& output,
+                         Combiner                      combiner,
+                         Terms...                      terms) {
+
+    const auto [min, max] = detail::fused_offsets<N>(terms...);
+
+    auto kernel = [&](auto i_span, auto o_span) {
+        fused_transform(policy, i_span, o_span, combiner, terms...);
+    };
+
+    detail::exchange_and_compute(policy, input, output, min, max, kernel);
+}
+
+/// @brief Exchanges the padding of the input array and evaluates all the input
+/// window and tile terms at every element of the input array, storing the
+/// result of combining them into the output array. Executed in order.
+/// @param input the input array whose padding is exchanged.
+/// @param output the output array.
+/// @param combiner function object taking the values of all the terms.
+/// @param terms the window_term and tile_term operations to evaluate.
+template <size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class Combiner,
+          class... Terms>
+static inline void
+exchange_fused_transform(DistributedArray<N, ET1, A1>& input,
+                         DistributedArray<N, ET2, A2>& output,
+                         Combiner                      combiner,
+                         Terms...                      terms) {
+
+    exchange_fused_transform(
+        std::execution::seq, input, output, combiner, terms...);
+}
+
+/// @brief Exchanges the padding of the input array once and advances the input
+/// array 'steps' times with the input unary window function, storing the
+/// result into the output array. The padding towards the neighbouring boxes
+/// (and periodic boundaries) must be deep enough for all the steps, i.e.
+/// 'steps' times the offsets accessed by f, and the values of the deep halo
+/// are advanced redundantly so that only one exchange is needed per 'steps'
+/// steps. The padding on the non-periodic domain boundaries is kept fixed.
+/// Each local block is processed in cache-sized tiles advancing all the steps
+/// at once, see temporal_window_transform. Executed according to policy (not
+/// necessarily in order).
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param input the input array whose padding is exchanged.
+/// @param output the output array.
+/// @param f the unary window operation. Example: f = [](auto accessor){return
+/// accessor(1,0) + accessor(-1,0);};
+/// @param steps the number of steps to advance.
+/// @param traversal the tile sizes, zero sizes are chosen automatically.
+template <class ExecutionPolicy,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryWindowFunction>
+static inline void
+exchange_temporal_window_transform(
+    ExecutionPolicy&&             policy,
+    DistributedArray<N, ET1, A1>& input,
+    DistributedArray<N, ET2, A2>& output,
+    UnaryWindowFunction           f,
+    size_t                        steps,
+    Blocked<N>                    traversal = {}) {
+
+    runtime_assert(steps > 0, "Zero steps in temporal window transform");
+
+    const auto [min, max] = md_min_max_offset<N>(f);
+    const auto k          = index_type(steps);
+    const auto bpad       = input.get_begin_padding();
+    const auto epad       = input.get_end_padding();
+    const auto periods    = input.topology().get_periods();
+
+    mpi_send_receive(policy, input);
+
+    ScopedTimer timer(Phase::Kernel);
+
+    const auto& boxes  = input.get_local_boxes();
+    const auto& i_data = std::as_const(input).get_local_data();
+    const auto& o_data = output.get_local_data();
+
+    for (size_t n = 0; n < boxes.size(); ++n) {
+
+        const auto& box = boxes[n].box;
+
+        std::array<bool, N>       shrink_begin{};
+        std::array<bool, N>       shrink_end{};
+        std::array<index_type, N> begin = bpad;
+        std::array<index_type, N> end =
+            get_end(bpad, extent_to_array(box.get_extent()));
+
+        for (size_t i = 0; i < N; ++i) {
+            std::array<index_type, N> dir{};
+
+            // Only the sides facing other boxes have a deep halo
+            dir[i] = -1;
+            shrink_begin[i] =
+                periods[i] || !box_on_boundary(box, input.topology(), dir);
+            dir[i] = 1;
+            shrink_end[i] =
+                periods[i] || !box_on_boundary(box, input.topology(), dir);
+
+            const auto reach_b = shrink_begin[i] ? k : 1;
+            const auto reach_e = shrink_end[i] ? k : 1;
+            runtime_assert(-min[i] * reach_b <= bpad[i] &&
+                               max[i] * reach_e <= epad[i],
+                           "Stencil reach exceeds the padding");
+
+            if (shrink_begin[i]) { begin[i] -= (k - 1) * -min[i]; }
+            if (shrink_end[i]) { end[i] += (k - 1) * max[i]; }
+        }
+
+        const auto padded = add_padding(box.get_extent(), bpad, epad);
+
+        auto i_span = make_subspan(make_span(i_data[n], padded), begin, end);
+        auto o_span = make_subspan(make_span(o_data[n], padded), begin, end);
+
+        detail::temporal_window_transform(policy,
+                                          i_span,
+                                          o_span,
+                                          f,
+                                          steps,
+                                          shrink_begin,
+                                          shrink_end,
+                                          traversal);
+    }
+}
+
+/// @brief Exchanges the padding of the input array once and advances the input
+/// array 'steps' times with the input unary window function, storing the
+/// result into the output array. Executed in order.
+/// @param input the input array whose padding is exchanged.
+/// @param output the output array.
+/// @param f the unary window operation.
+/// @param steps the number of steps to advance.
+template <size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryWindowFunction>
+static inline void
+exchange_temporal_window_transform(DistributedArray<N, ET1, A1>& input,
+                                   DistributedArray<N, ET2, A2>& output,
+                                   UnaryWindowFunction           f,
+                                   size_t                        steps) {
+
+    exchange_temporal_window_transform(
+        std::execution::seq, input, output, f, steps);
+}
+
+/// @brief Exchanges the padding of the input array and applies the input unary
+/// tile function to all elements of the input array storing the result into
+/// the output array. The elements which do not depend on the padding are
+/// computed while the exchange is in progress. A tile accessor is one
+/// dimensional. Executed according to policy (not necessarily in order).
+/// @tparam Dir the direction (index) along which the tile is created.
+/// @param policy the execution policy to use. See execution policy for details.
+/// @param input the input array whose padding is exchanged.
+/// @param output the output array.
+/// @param f the unary tile operation. Example: f = [](auto accessor){return
+/// accessor(0) + accessor(1);};
+template <size_t Dir,
+          class ExecutionPolicy,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryTileFunction>
+static inline void exchange_tile_transform(ExecutionPolicy&&             policy,
+                                           DistributedArray<N, ET1, A1>& input,
+                                           DistributedArray<N, ET2, A2>& output,
+                                           UnaryTileFunction             f) {
+
+    static_assert(Dir < N, "Tile direction out of bounds");
+
+    const auto [tmin, tmax] = min_max_offset(f);
+
+    std::array<index_type, N> min{};
+    std::array<index_type, N> max{};
+    min[Dir] = tmin;
+    max[Dir] = tmax;
+
+    auto kernel = [&](auto i_span, auto o_span) {
+        tile_transform<Dir>(policy, i_span, o_span, f);
+    };
+
+    detail::exchange_and_compute(policy, input, output, min, max, kernel);
+}
+
+/// @brief Exchanges the padding of the input array and applies the input unary
+/// tile function to all elements of the input array storing the result into
+/// the output array. Executed in order.
+/// @tparam Dir the direction (index) along which the tile is created.
+/// @param input the input array whose padding is exchanged.
+/// @param output the output array.
+/// @param f the unary tile operation. Example: f = [](auto accessor){return
+/// accessor(0) + accessor(1);};
+template <size_t Dir,
+          size_t N,
+          class ET1,
+          class A1,
+          class ET2,
+          class A2,
+          class UnaryTileFunction>
+static inline void exchange_tile_transform(DistributedArray<N, ET1, A1>& input,
+                                           DistributedArray<N, ET2, A2>& output,
+                                           UnaryTileFunction             f) {
+
+    exchange_tile_transform<Dir>(std::execution::seq, input, output, f);
+}
 
 } // namespace jada
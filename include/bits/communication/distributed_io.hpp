@@ -0,0 +1,356 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "distributed_array.hpp"
+#include "mpi_functions.hpp"
+
+namespace jada {
+
+namespace detail {
+
+///
+///@brief Splits the box into slabs along the first dimension so that each
+/// slab holds at most max_elements elements (but at least one row). The slabs
+/// are contiguous in the row-major order of the box.
+///
+///@param box the box to split
+///@param max_elements the maximum element count of a slab
+///@return std::vector<Box<N>> the slabs in order
+///
+template <size_t N>
+static inline std::vector<Box<N>> split_rows(const Box<N>& box,
+                                             size_t        max_elements) {
+
+    const auto dims = extent_to_array(box.get_extent());
+
+    size_t row_size = 1;
+    for (size_t i = 1; i < N; ++i) { row_size *= size_t(dims[i]); }
+
+    // Clamped to the box, max_elements may not fit into index_type
+    const size_t max_rows = max_elements / std::max(row_size, size_t(1));
+    const auto   rows     = index_type(std::clamp(
+        max_rows, size_t(1), std::max(size_t(dims[0]), size_t(1))));
+
+    std::vector<Box<N>> ret;
+    for (index_type j = box.begin[0]; j < box.end[0]; j += rows) {
+        auto slab     = box;
+        slab.begin[0] = j;
+        slab.end[0]   = std::min(j + rows, box.end[0]);
+        ret.push_back(slab);
+    }
+    return ret;
+}
+
+///
+///@brief Creates a committed subarray datatype describing the region of the
+/// local block 'block' of the array which corresponds to the global box
+/// 'region'. The padding of the block is excluded, so that the block can be
+/// sent or written without packing.
+///
+///@param array the distributed array
+///@param block the index of the local block
+///@param region a global box inside the local box of the block
+///@return MPI_Datatype the committed datatype, to be freed by the caller
+///
+template <size_t N, class T, class A>
+static inline MPI_Datatype
+block_datatype(const DistributedArray<N, T, A>& array,
+               size_t                           block,
+               const Box<N>&                    region) {
+
+    const auto& box   = array.get_local_boxes()[block].box;
+    const auto  bpad  = array.get_begin_padding();
+    const auto  pdims = extent_to_array(add_padding(
+        box.get_extent(), bpad, array.get_end_padding()));
+    const auto  dims  = extent_to_array(region.get_extent());
+
+    std::array<int, N> sizes{};
+    std::array<int, N> subsizes{};
+    std::array<int, N> starts{};
+    for (size_t i = 0; i < N; ++i) {
+        sizes[i]    = int(pdims[i]);
+        subsizes[i] = int(dims[i]);
+        starts[i]   = bpad[i] + region.begin[i] - box.begin[i];
+    }
+    auto t = mpi::type_create_subarray<N>(
+        sizes, subsizes, starts, mpi::MakeDatatype<T>{}());
+    mpi::type_commit(t);
+    return t;
+}
+
+///
+///@brief Creates a committed subarray datatype describing the global box
+/// 'region' in a row-major array, in memory or in a file, holding the whole
+/// domain.
+///
+///@param domain the domain of the row-major array
+///@param region the box inside the domain
+///@return MPI_Datatype the committed datatype, to be freed by the caller
+///
+template <class T, size_t N>
+static inline MPI_Datatype domain_datatype(const Box<N>& domain,
+                                           const Box<N>& region) {
+
+    const auto ddims = extent_to_array(domain.get_extent());
+    const auto rdims = extent_to_array(region.get_extent());
+
+    std::array<int, N> sizes{};
+    std::array<int, N> subsizes{};
+    std::array<int, N> starts{};
+    for (size_t i = 0; i < N; ++i) {
+        sizes[i]    = int(ddims[i]);
+        subsizes[i] = int(rdims[i]);
+        starts[i]   = region.begin[i] - domain.begin[i];
+    }
+    auto t = mpi::type_create_subarray<N>(
+        sizes, subsizes, starts, mpi::MakeDatatype<T>{}());
+    mpi::type_commit(t);
+    return t;
+}
+
+} // namespace detail
+
+///
+///@brief Streams the global data of the array to the root process. The boxes
+/// of the topology are visited in order and split into slabs of at most
+/// chunk_elements elements. For each slab the root process calls f(region,
+/// span), where region is the global box of the slab and span a read-only
+/// view to its data. Slabs owned by the root are passed directly from the
+/// local storage, others are received into a single buffer of at most
+/// chunk_elements elements, so the memory use on root does not depend on the
+/// domain size. The senders transfer the slabs straight from their padded
+/// blocks using subarray datatypes. Collective over the processes of the
+/// topology, f is only called on root.
+///
+///@param array the array to gather
+///@param f function object called as f(Box<N>, span) on root
+///@param root the process receiving the data
+///@param chunk_elements maximum element count of a single message
+///@param comm the communicator of the processes
+///
+template <size_t N, class T, class A, class BoxFunction>
+void gather_to_root(const DistributedArray<N, T, A>& array,
+                    BoxFunction                      f,
+                    int                              root           = 0,
+                    size_t                           chunk_elements =
+                        std::numeric_limits<size_t>::max(),
+                    MPI_Comm                         comm = MPI_COMM_WORLD) {
+
+    using view_type = span_base<const T, N, stdex::layout_stride>;
+
+    const int   rank   = array.get_rank();
+    const auto& blocks = array.get_local_data();
+    const auto& spans  = make_subspans(array);
+    const auto  etype  = mpi::MakeDatatype<T>{}();
+    const int   tag    = 0;
+
+    if (rank != root) {
+        const auto& boxes = array.get_local_boxes();
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            for (const auto& slab : detail::split_rows(boxes[i].box,
+                                                       chunk_elements)) {
+                if (slab.size() == 0) { continue; }
+                auto t = detail::block_datatype(array, i, slab);
+                mpi::send(blocks[i].data(), 1, t, root, tag, comm);
+                mpi::type_free(t);
+            }
+        }
+        return;
+    }
+
+    std::vector<T> buffer;
+    size_t         local = 0;
+    for (const auto& pair : array.topology().get_boxes()) {
+
+        for (const auto& slab : detail::split_rows(pair.box, chunk_elements)) {
+            if (slab.size() == 0) { continue; }
+
+            if (pair.rank == root) {
+                auto begin = slab.begin;
+                auto end   = slab.end;
+                for (size_t i = 0; i < N; ++i) {
+                    begin[i] -= pair.box.begin[i];
+                    end[i] -= pair.box.begin[i];
+                }
+                f(slab, view_type(make_subspan(spans[local], begin, end)));
+            } else {
+                buffer.resize(size_t(slab.size()));
+                mpi::recv(buffer.data(),
+                          int(buffer.size()),
+                          etype,
+                          pair.rank,
+                          tag,
+                          comm);
+                const auto& cbuffer = buffer;
+                f(slab, view_type(make_span(cbuffer, slab.get_extent())));
+            }
+        }
+        if (pair.rank == root) { ++local; }
+    }
+}
+
+///
+///@brief Gathers the global data of the array to the root process. Unlike
+/// to_vector, only the root process allocates the global data and each
+/// element is transferred once. Collective over the processes of the topology.
+///
+///@param array the array to gather
+///@param root the process receiving the data
+///@param comm the communicator of the processes
+///@return std::vector<T> the global row-major data on root, empty on others
+///
+template <size_t N, class T, class A>
+std::vector<T> gather_to_root(const DistributedArray<N, T, A>& array,
+                              int                              root = 0,
+                              MPI_Comm comm = MPI_COMM_WORLD) {
+
+    std::vector<T> global;
+
+    const auto domain = array.topology().get_domain();
+    if (array.get_rank() == root) {
+        global.resize(flat_size(domain.get_extent()));
+    }
+    // Only called on root where the global data is allocated
+    auto copy = [&](const Box<N>& region, auto span) {
+        auto bigspan = make_span(global, domain.get_extent());
+        auto begin = region.begin;
+        auto end   = region.end;
+        for (size_t i = 0; i < N; ++i) {
+            begin[i] -= domain.begin[i];
+            end[i] -= domain.begin[i];
+        }
+        transform(
+            span, make_subspan(bigspan, begin, end), [](auto e) { return e; });
+    };
+
+    gather_to_root(
+        array, copy, root, std::numeric_limits<size_t>::max(), comm);
+
+    return global;
+}
+
+///
+///@brief Creates a distributed array from global row-major data which is only
+/// present on the root process. Root sends each other process only its own
+/// boxes, directly from the global data to the padded blocks of the receiver
+/// using subarray datatypes on both sides, so the other processes never hold
+/// more than their local data. The padding of the returned array is set to
+/// T{}. Collective over the processes of the topology.
+///
+///@param data the global row-major data on root, ignored on other processes
+/// (may be empty)
+///@param topo the topology describing the distribution of the data
+///@param rank the rank of the calling process in the topology
+///@param begin_padding padding used for the beginning of the local boxes
+///@param end_padding padding used for the end of the local boxes
+///@param root the process holding the data
+///@param comm the communicator of the processes
+///@return DistributedArray of rank N and with the element type of data
+///
+template <size_t N, class Data>
+auto scatter_from_root(const Data&               data,
+                       const Topology<N>&        topo,
+                       int                       rank,
+                       std::array<index_type, N> begin_padding,
+                       std::array<index_type, N> end_padding,
+                       int                       root = 0,
+                       MPI_Comm                  comm = MPI_COMM_WORLD) {
+
+    using T = typename Data::value_type;
+
+    DistributedArray<N, T> ret(rank, topo, begin_padding, end_padding);
+
+    const auto& boxes  = ret.get_local_boxes();
+    const auto& blocks = ret.get_local_data();
+    const int   tag    = 0;
+
+    std::vector<MPI_Request>  requests;
+    std::vector<MPI_Datatype> types;
+
+    if (rank != root) {
+        // Posted in local box order which matches the send order on root
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].box.size() == 0) { continue; }
+            types.push_back(detail::block_datatype(ret, i, boxes[i].box));
+            requests.push_back(
+                mpi::irecv(blocks[i].data(), 1, types.back(), root, tag, comm));
+        }
+    } else {
+        const auto& domain = topo.get_domain();
+        runtime_assert(std::size(data) == flat_size(domain.get_extent()),
+                       "Dimension mismatch in scatter_from_root");
+
+        for (const auto& pair : topo.get_boxes()) {
+            if (pair.rank == root || pair.box.size() == 0) { continue; }
+            types.push_back(detail::domain_datatype<T>(domain, pair.box));
+            requests.push_back(mpi::isend(
+                std::data(data), 1, types.back(), pair.rank, tag, comm));
+        }
+
+        const auto  i_spans = make_subspans(data, topo, root);
+        const auto& o_spans = make_subspans(ret);
+        for (size_t i = 0; i < i_spans.size(); ++i) {
+            transform(i_spans[i], o_spans[i], [](auto e) { return e; });
+        }
+    }
+
+    mpi::wait_all(requests);
+    for (auto& t : types) { mpi::type_free(t); }
+
+    return ret;
+}
+
+///
+///@brief Collectively writes the array to a file holding the whole domain in
+/// row-major order without any header, i.e. the same layout as the vector
+/// returned by to_vector. Each process writes its boxes in place through
+/// subarray file views with MPI-IO collective writes, so no process holds
+/// more than its own data. The file is truncated to the size of the domain.
+///
+///@param array the array to write
+///@param filename the name of the file
+///@param comm the communicator of the processes
+///
+template <size_t N, class T, class A>
+void write_row_major(const DistributedArray<N, T, A>& array,
+                     const std::string&               filename,
+                     MPI_Comm                         comm = MPI_COMM_WORLD) {
+
+    const auto  domain = array.topology().get_domain();
+    const auto& boxes  = array.get_local_boxes();
+    const auto& blocks = array.get_local_data();
+    const auto  etype  = mpi::MakeDatatype<T>{}();
+
+    auto fh =
+        mpi::file_open(comm, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY);
+
+    mpi::file_set_size(
+        fh, MPI_Offset(flat_size(domain.get_extent()) * sizeof(T)));
+
+    // Collective writes have to be matched, so all processes loop over the
+    // largest local box count and write nothing once they run out of boxes.
+    const size_t rounds = mpi::all_reduce(boxes.size(), Maximum{}, comm);
+
+    for (size_t i = 0; i < rounds; ++i) {
+
+        if (i < boxes.size() && boxes[i].box.size() > 0) {
+            auto ftype = detail::domain_datatype<T>(domain, boxes[i].box);
+            auto mtype = detail::block_datatype(array, i, boxes[i].box);
+            mpi::file_set_view(fh, 0, etype, ftype);
+            mpi::file_write_all(fh, blocks[i].data(), 1, mtype);
+            mpi::type_free(mtype);
+            mpi::type_free(ftype);
+        } else {
+            mpi::file_set_view(fh, 0, etype, etype);
+            mpi::file_write_all(fh, nullptr, 0, etype);
+        }
+    }
+
+    mpi::file_close(fh);
+}
+
+} // namespace jada
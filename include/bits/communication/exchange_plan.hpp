@@ -0,0 +1,667 @@
+#pragma once
+
+#include <algorithm>
+#include <execution>
+#include <map>
+#include <span>
+
+#include "channel.hpp"
+#include "include/bits/algorithms/algorithms.hpp"
+#include "mpi_functions.hpp"
+#include "profiler.hpp"
+
+namespace jada {
+
+///
+///@brief A transfer scheduled by an exchange plan.
+///
+///@tparam N number of spatial dimensions
+///
+template <size_t N> struct PlannedTransfer {
+    TransferInfo<N> info;
+    size_t          block;  // index of the local box sending/receiving
+    size_t          offset; // offset in the packed send/receive buffer
+    int             tag;    // sequence number between the pair of processes
+};
+
+///
+///@brief A transfer between two boxes of the same process, copied directly
+/// from the sender slice to the receiver padding without mpi.
+///
+///@tparam N number of spatial dimensions
+///
+template <size_t N> struct LocalTransfer {
+    TransferInfo<N> info;
+    size_t          sender_block;   // index of the local box sending
+    size_t          receiver_block; // index of the local box receiving
+};
+
+///
+///@brief A message of an exchange plan. All the transfers between a pair of
+/// processes are packed into a single message.
+///
+struct PlannedMessage {
+    int    peer;   // the rank of the other process
+    size_t offset; // offset in the packed send/receive buffer
+    size_t count;  // total element count of the transfers in the message
+    size_t first;  // index of the first transfer in the message
+    size_t last;   // one past the index of the last transfer in the message
+};
+
+namespace detail {
+
+///
+///@brief Lists all the transfers received by the local boxes of 'rank' from
+/// other processes. The transfers between a pair of processes are listed in
+/// (sender box, receiver box) order which matches the order of
+/// send_transfers() on the sender side. Transfers within 'rank' are listed by
+/// local_transfers().
+///
+///@param topology the topology describing the distribution of the data
+///@param begin_padding padding at the beginning of each local box
+///@param end_padding padding at the end of each local box
+///@param rank the rank of the receiving process
+///@return std::vector<PlannedTransfer<N>> the received transfers with packed
+/// buffer offsets
+///
+template <size_t N>
+auto receive_transfers(const Topology<N>&        topology,
+                       std::array<index_type, N> begin_padding,
+                       std::array<index_type, N> end_padding,
+                       int                       rank) {
+
+    const auto local = topology.get_boxes(rank);
+
+    std::vector<PlannedTransfer<N>> ret;
+    std::map<int, int>              tags;
+    size_t                          offset = 0;
+
+    for (const auto& sender : topology.get_boxes()) {
+        for (size_t i = 0; i < local.size(); ++i) {
+            for (const auto& info : topology.get_transfers(
+                     sender, local[i], begin_padding, end_padding)) {
+
+                if (info.sender_rank == rank) { continue; }
+                ret.push_back({info, i, offset, tags[info.sender_rank]++});
+                offset += flat_size(info.extent);
+            }
+        }
+    }
+    return ret;
+}
+
+///
+///@brief Lists all the transfers sent by the local boxes of 'rank' to other
+/// processes. The transfers between a pair of processes are listed in (sender
+/// box, receiver box) order which matches the order of receive_transfers() on
+/// the receiver side. Transfers within 'rank' are listed by local_transfers().
+///
+///@param topology the topology describing the distribution of the data
+///@param begin_padding padding at the beginning of each local box
+///@param end_padding padding at the end of each local box
+///@param rank the rank of the sending process
+///@return std::vector<PlannedTransfer<N>> the sent transfers with packed
+/// buffer offsets
+///
+template <size_t N>
+auto send_transfers(const Topology<N>&        topology,
+                    std::array<index_type, N> begin_padding,
+                    std::array<index_type, N> end_padding,
+                    int                       rank) {
+
+    const auto local = topology.get_boxes(rank);
+
+    std::vector<PlannedTransfer<N>> ret;
+    std::map<int, int>              tags;
+    size_t                          offset = 0;
+
+    for (size_t i = 0; i < local.size(); ++i) {
+        for (const auto& receiver : topology.get_boxes()) {
+            for (const auto& info : topology.get_transfers(
+                     local[i], receiver, begin_padding, end_padding)) {
+
+                if (info.receiver_rank == rank) { continue; }
+                ret.push_back({info, i, offset, tags[info.receiver_rank]++});
+                offset += flat_size(info.extent);
+            }
+        }
+    }
+    return ret;
+}
+
+///
+///@brief Lists all the transfers between the local boxes of 'rank', including
+/// the periodic transfers of a box to itself.
+///
+///@param topology the topology describing the distribution of the data
+///@param begin_padding padding at the beginning of each local box
+///@param end_padding padding at the end of each local box
+///@param rank the rank of the process
+///@return std::vector<LocalTransfer<N>> the transfers within the process
+///
+template <size_t N>
+auto local_transfers(const Topology<N>&        topology,
+                     std::array<index_type, N> begin_padding,
+                     std::array<index_type, N> end_padding,
+                     int                       rank) {
+
+    const auto local = topology.get_boxes(rank);
+
+    std::vector<LocalTransfer<N>> ret;
+    for (size_t i = 0; i < local.size(); ++i) {
+        for (size_t j = 0; j < local.size(); ++j) {
+            for (const auto& info : topology.get_transfers(
+                     local[i], local[j], begin_padding, end_padding)) {
+                ret.push_back({info, i, j});
+            }
+        }
+    }
+    return ret;
+}
+
+///
+///@brief Returns the N-dimensional view of a slice of a padded block.
+///
+///@param block the padded data of a box
+///@param dims the padded extent of the box
+///@param begin the begin index of the slice in padded coordinates
+///@param extent the extent of the slice
+///@return the subspan of the slice
+///
+template <size_t N, class T>
+auto block_slice(std::span<T>              block,
+                 std::array<size_type, N>  dims,
+                 std::array<index_type, N> begin,
+                 std::array<size_type, N>  extent) {
+    return make_subspan(make_span(block, dims), begin, get_end(begin, extent));
+}
+
+///
+///@brief Copies the sent slice of a local transfer directly to the padding of
+/// the receiving block. The copy is executed according to policy.
+///
+///@param policy the execution policy to use
+///@param t the transfer to copy
+///@param blocks the padded data of each local box
+///@param dims the padded extent of each local box
+///
+template <class ExecutionPolicy, size_t N, class T>
+void copy_local(ExecutionPolicy&&                            policy,
+                const LocalTransfer<N>&                      t,
+                const std::vector<std::span<T>>&             blocks,
+                const std::vector<std::array<size_type, N>>& dims) {
+
+    auto from = block_slice(blocks[t.sender_block],
+                            dims[t.sender_block],
+                            t.info.sender_begin,
+                            t.info.extent);
+    auto to   = block_slice(blocks[t.receiver_block],
+                          dims[t.receiver_block],
+                          t.info.receiver_begin,
+                          t.info.extent);
+    transform(policy, from, to, [](auto val) { return val; });
+}
+
+///
+///@brief Returns the total element count of the input transfers.
+///
+///@param transfers the transfers to compute the size of
+///@return size_t sum of the transfer sizes
+///
+template <size_t N>
+size_t packed_size(const std::vector<PlannedTransfer<N>>& transfers) {
+    size_t ret = 0;
+    for (const auto& t : transfers) { ret += flat_size(t.info.extent); }
+    return ret;
+}
+
+///
+///@brief Orders the input transfers by the rank of the other process and
+/// groups the transfers between each pair of processes into a single message.
+/// The order of the transfers within a message is preserved so that the
+/// packed layouts of the sender and the receiver match. The buffer offsets of
+/// the transfers are recomputed to be contiguous within each message.
+///
+///@param transfers the transfers to group, reordered in place
+///@param peer returns the rank of the other process of a transfer
+///@return std::vector<PlannedMessage> the messages in ascending peer order
+///
+template <size_t N, class Peer>
+std::vector<PlannedMessage> group_by_peer(
+    std::vector<PlannedTransfer<N>>& transfers, Peer peer) {
+
+    std::stable_sort(transfers.begin(),
+                     transfers.end(),
+                     [=](const auto& lhs, const auto& rhs) {
+                         return peer(lhs) < peer(rhs);
+                     });
+
+    std::vector<PlannedMessage> ret;
+    size_t                      offset = 0;
+
+    for (size_t i = 0; i < transfers.size(); ++i) {
+
+        auto& t    = transfers[i];
+        auto  size = flat_size(t.info.extent);
+
+        if (ret.empty() || ret.back().peer != peer(t)) {
+            ret.push_back({peer(t), offset, 0, i, i});
+        }
+
+        t.offset = offset;
+        ret.back().count += size;
+        ret.back().last = i + 1;
+        offset += size;
+    }
+    return ret;
+}
+
+} // namespace detail
+
+///
+///@brief The ways an exchange plan can move the halo data.
+///
+enum class ExchangeMethod {
+    Pack,    // copy the slices to contiguous buffers before/after transfer
+    Subarray // describe the slices with derived datatypes (zero-copy)
+};
+
+///
+///@brief A precomputed halo exchange for a fixed topology, padding and rank.
+/// The transfers, message layouts and persistent mpi requests are created once
+/// so that repeated exchanges only pack, start, wait and unpack. All the
+/// transfers between a pair of processes are aggregated into a single message,
+/// so that each exchange sends at most one message per neighbouring process.
+/// Transfers between the boxes of the calling process are copied directly from
+/// the sender slice to the receiver padding without mpi or buffers.
+/// With ExchangeMethod::Subarray each transfer is described by a committed
+/// subarray datatype over the padded block and mpi reads and writes the
+/// strided slices in place. In that case the messages and the persistent
+/// requests are bound to the block addresses and recreated only when the blocks
+/// given to start() move. Each exchange is started with start() and completed
+/// with wait() or test(). The blocks given to start() must not be modified nor
+/// destroyed before the exchange has completed. The execution policy given to
+/// start(), wait() and test() is used for packing and unpacking, independent
+/// transfers are processed concurrently under a parallel policy. A plan
+/// destroyed with a running exchange completes it without throwing.
+///
+///@tparam N number of spatial dimensions
+///@tparam T the element type of the exchanged data
+///
+template <size_t N, class T> class ExchangePlan {
+
+public:
+    ExchangePlan(const Topology<N>&        topology,
+                 std::array<index_type, N> begin_padding,
+                 std::array<index_type, N> end_padding,
+                 int                       rank,
+                 ExchangeMethod            method = ExchangeMethod::Pack,
+                 MPI_Comm                  comm   = MPI_COMM_WORLD)
+        : m_comm(comm)
+        , m_method(method)
+        , m_sends(detail::send_transfers(
+              topology, begin_padding, end_padding, rank))
+        , m_recvs(detail::receive_transfers(
+              topology, begin_padding, end_padding, rank))
+        , m_locals(detail::local_transfers(
+              topology, begin_padding, end_padding, rank))
+        , m_send_messages(detail::group_by_peer(
+              m_sends, [](const auto& t) { return t.info.receiver_rank; }))
+        , m_recv_messages(detail::group_by_peer(
+              m_recvs, [](const auto& t) { return t.info.sender_rank; })) {
+
+        for (const auto& box : topology.get_boxes(rank)) {
+            m_padded_dims.push_back(extent_to_array(
+                add_padding(box.get_extent(), begin_padding, end_padding)));
+        }
+
+        if (m_method == ExchangeMethod::Subarray) {
+            for (const auto& t : m_recvs) {
+                m_recv_types.push_back(
+                    make_type(t.block, t.info.receiver_begin, t.info.extent));
+            }
+            for (const auto& t : m_sends) {
+                m_send_types.push_back(
+                    make_type(t.block, t.info.sender_begin, t.info.extent));
+            }
+            return;
+        }
+
+        m_send_buffer.resize(detail::packed_size(m_sends));
+        m_recv_buffer.resize(detail::packed_size(m_recvs));
+
+        for (const auto& m : m_recv_messages) {
+            m_requests.push_back(
+                mpi::recv_init(m_recv_buffer.data() + m.offset,
+                               static_cast<int>(m.count),
+                               mpi::MakeDatatype<T>{}(),
+                               m.peer,
+                               message_tag,
+                               m_comm));
+        }
+
+        for (const auto& m : m_send_messages) {
+            m_requests.push_back(
+                mpi::send_init(m_send_buffer.data() + m.offset,
+                               static_cast<int>(m.count),
+                               mpi::MakeDatatype<T>{}(),
+                               m.peer,
+                               message_tag,
+                               m_comm));
+        }
+    }
+
+    ExchangePlan(const ExchangePlan&)            = delete;
+    ExchangePlan& operator=(const ExchangePlan&) = delete;
+
+    ExchangePlan(ExchangePlan&& other) noexcept { swap(other); }
+
+    ExchangePlan& operator=(ExchangePlan&& other) noexcept {
+        if (this != &other) {
+            ExchangePlan tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~ExchangePlan() noexcept {
+        if (mpi::finalized()) { return; }
+
+        // Errors can not be reported from the destructor, so a running
+        // exchange is completed without the checks of wait(), its unpacking
+        // is skipped if it fails and the mpi objects are freed unchecked
+        if (m_active) {
+            MPI_Waitall(static_cast<int>(m_requests.size()),
+                        m_requests.data(),
+                        MPI_STATUSES_IGNORE);
+            try {
+                finish(std::execution::seq);
+            } catch (...) {}
+        }
+        for (auto& r : m_requests) { MPI_Request_free(&r); }
+        for (auto& t : m_message_types) { MPI_Type_free(&t); }
+        for (auto& t : m_recv_types) { MPI_Type_free(&t); }
+        for (auto& t : m_send_types) { MPI_Type_free(&t); }
+    }
+
+    ///
+    ///@brief Packs the sent slices of the input blocks (if required by the
+    /// method), starts all the messages of the exchange and copies the
+    /// transfers within the process while the messages are in flight. The
+    /// copies are executed according to policy.
+    ///
+    ///@param policy the execution policy to use
+    ///@param blocks the padded data of each local box, blocks[i] corresponds
+    /// to topology.get_boxes(rank)[i]
+    ///
+    template <class ExecutionPolicy>
+    void start(ExecutionPolicy&& policy, std::vector<std::span<T>> blocks) {
+
+        runtime_assert(!m_active, "Exchange already in progress");
+        runtime_assert(blocks.size() == m_padded_dims.size(),
+                       "Block count mismatch in ExchangePlan");
+
+        m_blocks = std::move(blocks);
+
+        if (m_method == ExchangeMethod::Pack) {
+            ScopedTimer timer(Phase::Pack);
+            pack(policy);
+        }
+
+        {
+            ScopedTimer timer(Phase::Post);
+            if (m_method == ExchangeMethod::Subarray) { bind_requests(); }
+            mpi::start_all(m_requests);
+            m_active = true;
+        }
+
+        if constexpr (profiling_enabled) {
+            for (const auto& m : m_send_messages) {
+                record_sent(m.peer, m.count * sizeof(T));
+            }
+        }
+
+        ScopedTimer timer(Phase::LocalCopy);
+        detail::for_each_concurrent(policy, m_locals.size(), [&](size_t i) {
+            detail::copy_local(policy, m_locals[i], m_blocks, m_padded_dims);
+        });
+    }
+
+    ///
+    ///@brief Packs the sent slices of the input blocks and starts all the
+    /// messages of the exchange. Executed in order.
+    ///
+    ///@param blocks the padded data of each local box, blocks[i] corresponds
+    /// to topology.get_boxes(rank)[i]
+    ///
+    void start(std::vector<std::span<T>> blocks) {
+        start(std::execution::seq, std::move(blocks));
+    }
+
+    ///
+    ///@brief Blocks until all the messages of the exchange have completed and
+    /// makes sure the received data is in the padding of the blocks given to
+    /// start(). The unpacking is executed according to policy.
+    ///
+    ///@param policy the execution policy to use
+    ///
+    template <class ExecutionPolicy> void wait(ExecutionPolicy&& policy) {
+        if (!m_active) { return; }
+        {
+            ScopedTimer timer(Phase::Wait);
+            mpi::wait_all(m_requests);
+        }
+        finish(policy);
+    }
+
+    ///
+    ///@brief Blocks until all the messages of the exchange have completed and
+    /// makes sure the received data is in the padding of the blocks given to
+    /// start(). Executed in order.
+    ///
+    void wait() { wait(std::execution::seq); }
+
+    ///
+    ///@brief Checks without blocking if all the messages of the exchange have
+    /// completed. If so, makes sure the received data is in the padding of the
+    /// blocks given to start(). The unpacking is executed according to policy.
+    ///
+    ///@param policy the execution policy to use
+    ///@return true if the exchange has completed, false otherwise
+    ///
+    template <class ExecutionPolicy> bool test(ExecutionPolicy&& policy) {
+        if (!m_active) { return true; }
+        {
+            ScopedTimer timer(Phase::Wait);
+            if (!mpi::test_all(m_requests)) { return false; }
+        }
+        finish(policy);
+        return true;
+    }
+
+    ///
+    ///@brief Checks without blocking if all the messages of the exchange have
+    /// completed. If so, makes sure the received data is in the padding of the
+    /// blocks given to start(). Executed in order.
+    ///
+    ///@return true if the exchange has completed, false otherwise
+    ///
+    bool test() { return test(std::execution::seq); }
+
+    ///
+    ///@brief Checks if the last started exchange has been completed.
+    ///
+    ///@return true if no exchange is in progress, false otherwise
+    ///
+    bool is_complete() const { return !m_active; }
+
+    ///
+    ///@brief Returns the number of messages (sends and receives) of one
+    /// exchange, i.e. the number of neighbouring processes in both directions.
+    ///
+    ///@return size_t the number of messages
+    ///
+    size_t message_count() const {
+        return m_send_messages.size() + m_recv_messages.size();
+    }
+
+    ExchangeMethod method() const { return m_method; }
+
+    const auto& send_transfers() const { return m_sends; }
+    const auto& receive_transfers() const { return m_recvs; }
+    const auto& local_transfers() const { return m_locals; }
+    const auto& send_messages() const { return m_send_messages; }
+    const auto& receive_messages() const { return m_recv_messages; }
+
+private:
+    // All the transfers between a pair of processes are in a single message
+    static constexpr int message_tag = 0;
+
+    MPI_Comm                              m_comm   = MPI_COMM_WORLD;
+    ExchangeMethod                        m_method = ExchangeMethod::Pack;
+    bool                                  m_active = false;
+    std::vector<PlannedTransfer<N>>       m_sends;
+    std::vector<PlannedTransfer<N>>       m_recvs;
+    std::vector<LocalTransfer<N>>         m_locals;
+    std::vector<PlannedMessage>           m_send_messages;
+    std::vector<PlannedMessage>           m_recv_messages;
+    std::vector<T>                        m_send_buffer;
+    std::vector<T>                        m_recv_buffer;
+    std::vector<std::array<size_type, N>> m_padded_dims;
+    std::vector<MPI_Request>              m_requests;
+    std::vector<std::span<T>>             m_blocks;
+    std::vector<MPI_Datatype>             m_send_types;
+    std::vector<MPI_Datatype>             m_recv_types;
+    std::vector<MPI_Datatype>             m_message_types; // for Subarray
+    std::vector<T*>                       m_bound;         // for Subarray
+
+    MPI_Datatype make_type(size_t                    block,
+                           std::array<index_type, N> begin,
+                           std::array<size_type, N>  extent) const {
+
+        std::array<int, N> sizes{};
+        std::array<int, N> subsizes{};
+        for (size_t i = 0; i < N; ++i) {
+            sizes[i]    = static_cast<int>(m_padded_dims[block][i]);
+            subsizes[i] = static_cast<int>(extent[i]);
+        }
+        auto t = mpi::type_create_subarray<N>(
+            sizes, subsizes, begin, mpi::MakeDatatype<T>{}());
+        mpi::type_commit(t);
+        return t;
+    }
+
+    ///
+    ///@brief Combines the subarray types of the transfers of a message into a
+    /// single struct type with absolute block addresses (relative to
+    /// MPI_BOTTOM).
+    ///
+    MPI_Datatype
+    make_message_type(const PlannedMessage&                  m,
+                      const std::vector<PlannedTransfer<N>>& transfers,
+                      const std::vector<MPI_Datatype>&       types,
+                      const std::vector<T*>&                 ptrs) {
+
+        std::vector<int>          lengths(m.last - m.first, 1);
+        std::vector<MPI_Aint>     displacements;
+        std::vector<MPI_Datatype> message_types;
+        for (size_t i = m.first; i < m.last; ++i) {
+            displacements.push_back(mpi::get_address(ptrs[transfers[i].block]));
+            message_types.push_back(types[i]);
+        }
+
+        auto t = mpi::type_create_struct(lengths, displacements, message_types);
+        mpi::type_commit(t);
+        m_message_types.push_back(t);
+        return t;
+    }
+
+    void bind_requests() {
+
+        std::vector<T*> ptrs;
+        for (auto b : m_blocks) { ptrs.push_back(b.data()); }
+        if (ptrs == m_bound) { return; }
+
+        free_requests();
+
+        for (const auto& m : m_recv_messages) {
+            auto t = make_message_type(m, m_recvs, m_recv_types, ptrs);
+            m_requests.push_back(mpi::recv_init(
+                MPI_BOTTOM, 1, t, m.peer, message_tag, m_comm));
+        }
+        for (const auto& m : m_send_messages) {
+            auto t = make_message_type(m, m_sends, m_send_types, ptrs);
+            m_requests.push_back(mpi::send_init(
+                MPI_BOTTOM, 1, t, m.peer, message_tag, m_comm));
+        }
+        m_bound = ptrs;
+    }
+
+    void free_requests() {
+        for (auto r : m_requests) { mpi::request_free(r); }
+        for (auto& t : m_message_types) { mpi::type_free(t); }
+        m_requests.clear();
+        m_message_types.clear();
+        m_bound.clear();
+    }
+
+    template <class ExecutionPolicy> void pack(ExecutionPolicy&& policy) {
+
+        detail::for_each_concurrent(policy, m_sends.size(), [&](size_t i) {
+            const auto& t    = m_sends[i];
+            auto        from = detail::block_slice(m_blocks[t.block],
+                                            m_padded_dims[t.block],
+                                            t.info.sender_begin,
+                                            t.info.extent);
+            span<T, N> to(m_send_buffer.data() + t.offset,
+                          make_extent(t.info.extent));
+            transform(policy, from, to, [](auto val) { return val; });
+        });
+    }
+
+    template <class ExecutionPolicy> void finish(ExecutionPolicy&& policy) {
+
+        if constexpr (profiling_enabled) {
+            for (const auto& m : m_recv_messages) {
+                record_received(m.peer, m.count * sizeof(T));
+            }
+        }
+
+        if (m_method == ExchangeMethod::Pack) {
+            ScopedTimer timer(Phase::Unpack);
+            detail::for_each_concurrent(policy, m_recvs.size(), [&](size_t i) {
+                const auto& t  = m_recvs[i];
+                auto        to = detail::block_slice(m_blocks[t.block],
+                                              m_padded_dims[t.block],
+                                              t.info.receiver_begin,
+                                              t.info.extent);
+                span<const T, N> from(m_recv_buffer.data() + t.offset,
+                                      make_extent(t.info.extent));
+                transform(policy, from, to, [](auto val) { return val; });
+            });
+        }
+        m_active = false;
+    }
+
+    void swap(ExchangePlan& other) noexcept {
+        std::swap(m_comm, other.m_comm);
+        std::swap(m_method, other.m_method);
+        std::swap(m_active, other.m_active);
+        std::swap(m_sends, other.m_sends);
+        std::swap(m_recvs, other.m_recvs);
+        std::swap(m_locals, other.m_locals);
+        std::swap(m_send_messages, other.m_send_messages);
+        std::swap(m_recv_messages, other.m_recv_messages);
+        std::swap(m_send_buffer, other.m_send_buffer);
+        std::swap(m_recv_buffer, other.m_recv_buffer);
+        std::swap(m_padded_dims, other.m_padded_dims);
+        std::swap(m_requests, other.m_requests);
+        std::swap(m_blocks, other.m_blocks);
+        std::swap(m_send_types, other.m_send_types);
+        std::swap(m_recv_types, other.m_recv_types);
+        std::swap(m_message_types, other.m_message_types);
+        std::swap(m_bound, other.m_bound);
+    }
+};
+
+} // namespace jada
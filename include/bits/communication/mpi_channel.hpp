@@ -19,10 +19,16 @@ std::ostream& operator<<(std::ostream& os, const MpiChannel<L, TT>& v) {
     return os;
 }
 
+///
+///@brief Returns the mpi datatype of the elements sent through the channel.
+///
+///@param channel the channel to query
+///@return MPI_Datatype the element datatype
+///
 template <size_t N, class T>
 auto create_datatype(const MpiChannel<N, T>& channel) {
-    (void) channel;
-    return MPI_INT;
+    (void)channel;
+    return mpi::MakeDatatype<T>{}();
 }
 
 template <size_t N, class T>
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "channel.hpp"
+#include "include/bits/algorithms/algorithms.hpp"
+#include "mpi_functions.hpp"
+#include "profiler.hpp"
+
+namespace jada {
+
+///
+///@brief A handle to a nonblocking halo exchange. The handle owns the send and
+/// receive buffers of all the posted messages and copies the received data to
+/// the padding of the receiving blocks once all the messages have completed.
+/// The receiving blocks must outlive the handle. If the exchange has not been
+/// completed when the handle is destroyed, the destructor blocks until it has.
+/// The destructor does not throw, errors of such an exchange are ignored.
+///
+///@tparam N number of spatial dimensions
+///@tparam T the element type of the exchanged data
+///
+template <size_t N, class T> class MpiExchangeHandle {
+
+public:
+    using target_span = span_base<T, N, stdex::layout_stride>;
+
+    MpiExchangeHandle() = default;
+
+    explicit MpiExchangeHandle(MPI_Comm comm)
+        : m_comm(comm) {}
+
+    MpiExchangeHandle(const MpiExchangeHandle&)            = delete;
+    MpiExchangeHandle& operator=(const MpiExchangeHandle&) = delete;
+
+    MpiExchangeHandle(MpiExchangeHandle&& other) noexcept { swap(other); }
+
+    MpiExchangeHandle& operator=(MpiExchangeHandle&& other) noexcept {
+        if (this != &other) {
+            MpiExchangeHandle tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~MpiExchangeHandle() noexcept {
+        if (m_complete) { return; }
+
+        // Errors can not be reported from the destructor, so the requests are
+        // completed without the checks of wait() and the unpacking is skipped
+        // if it fails
+        MPI_Waitall(static_cast<int>(m_requests.size()),
+                    m_requests.data(),
+                    MPI_STATUSES_IGNORE);
+        try {
+            finish(std::execution::seq);
+        } catch (...) {}
+    }
+
+    ///
+    ///@brief Starts a nonblocking receive of the transfer 'info' into the
+    /// region 'target' of a local block.
+    ///
+    ///@param info the transfer to receive
+    ///@param target the padding region of the receiving block
+    ///@param tag the message tag
+    ///
+    void post_receive(const TransferInfo<N>& info,
+                      target_span            target,
+                      int                    tag) {
+
+        auto& buffer = m_recv_buffers.emplace_back(flat_size(info.extent));
+        m_targets.push_back(target);
+
+        m_requests.push_back(mpi::irecv(buffer.data(),
+                                        static_cast<int>(buffer.size()),
+                                        mpi::MakeDatatype<T>{}(),
+                                        info.sender_rank,
+                                        tag,
+                                        m_comm));
+        record_received(info.sender_rank, buffer.size() * sizeof(T));
+        m_complete = false;
+    }
+
+    ///
+    ///@brief Starts a nonblocking send of the packed slice 'buffer'
+    /// corresponding to the transfer 'info'. The handle takes the ownership of
+    /// the buffer until the send has completed.
+    ///
+    ///@param info the transfer to send
+    ///@param buffer the packed slice of the sending block
+    ///@param tag the message tag
+    ///
+    void
+    post_send(const TransferInfo<N>& info, std::vector<T> buffer, int tag) {
+
+        auto& b = m_send_buffers.emplace_back(std::move(buffer));
+
+        m_requests.push_back(mpi::isend(b.data(),
+                                        static_cast<int>(b.size()),
+                                        mpi::MakeDatatype<T>{}(),
+                                        info.receiver_rank,
+                                        tag,
+                                        m_comm));
+        record_sent(info.receiver_rank, b.size() * sizeof(T));
+        m_complete = false;
+    }
+
+    ///
+    ///@brief Blocks until all the messages of the exchange have completed and
+    /// copies the received data to the padding of the receiving blocks.
+    ///
+    void wait() { wait(std::execution::seq); }
+
+    ///
+    ///@brief Blocks until all the messages of the exchange have completed and
+    /// copies the received data to the padding of the receiving blocks. The
+    /// copies are executed according to policy.
+    ///
+    ///@param policy the execution policy to use
+    ///
+    template <class ExecutionPolicy> void wait(ExecutionPolicy&& policy) {
+        if (m_complete) { return; }
+        {
+            ScopedTimer timer(Phase::Wait);
+            mpi::wait_all(m_requests);
+        }
+        finish(policy);
+    }
+
+    ///
+    ///@brief Checks without blocking if all the messages of the exchange have
+    /// completed. If so, copies the received data to the padding of the
+    /// receiving blocks.
+    ///
+    ///@return true if the exchange has completed, false otherwise
+    ///
+    bool test() { return test(std::execution::seq); }
+
+    ///
+    ///@brief Checks without blocking if all the messages of the exchange have
+    /// completed. If so, copies the received data to the padding of the
+    /// receiving blocks. The copies are executed according to policy.
+    ///
+    ///@param policy the execution policy to use
+    ///@return true if the exchange has completed, false otherwise
+    ///
+    template <class ExecutionPolicy> bool test(ExecutionPolicy&& policy) {
+        if (m_complete) { return true; }
+        {
+            ScopedTimer timer(Phase::Wait);
+            if (!mpi::test_all(m_requests)) { return false; }
+        }
+        finish(policy);
+        return true;
+    }
+
+    ///
+    ///@brief Checks if the exchange has been completed by wait() or test().
+    ///
+    ///@return true if the received data is in place, false otherwise
+    ///
+    bool is_complete() const { return m_complete; }
+
+    ///
+    ///@brief Returns the number of messages (sends and receives) posted by this
+    /// handle.
+    ///
+    ///@return size_t the number of posted messages
+    ///
+    size_t message_count() const { return m_requests.size(); }
+
+private:
+    MPI_Comm                    m_comm     = MPI_COMM_WORLD;
+    bool                        m_complete = true;
+    std::vector<MPI_Request>    m_requests;
+    std::vector<std::vector<T>> m_send_buffers;
+    std::vector<std::vector<T>> m_recv_buffers;
+    std::vector<target_span>    m_targets;
+
+    template <class ExecutionPolicy> void finish(ExecutionPolicy&& policy) {
+
+        ScopedTimer timer(Phase::Unpack);
+        detail::for_each_concurrent(
+            policy, m_recv_buffers.size(), [&](size_t i) {
+                auto from = make_span(m_recv_buffers[i],
+                                      extent_to_array(extent(m_targets[i])));
+                transform(
+                    policy, from, m_targets[i], [](auto val) { return val; });
+            });
+
+        m_requests.clear();
+        m_send_buffers.clear();
+        m_recv_buffers.clear();
+        m_targets.clear();
+        m_complete = true;
+    }
+
+    void swap(MpiExchangeHandle& other) noexcept {
+        std::swap(m_comm, other.m_comm);
+        std::swap(m_complete, other.m_complete);
+        std::swap(m_requests, other.m_requests);
+        std::swap(m_send_buffers, other.m_send_buffers);
+        std::swap(m_recv_buffers, other.m_recv_buffers);
+        std::swap(m_targets, other.m_targets);
+    }
+};
+
+} // namespace jada
@@ -1,7 +1,14 @@
 #pragma once
 
+#include <complex>
+#include <cstddef>
+#include <functional>
 #include <mpi.h>
+#include <string>
+#include <type_traits>
+#include <vector>
 
+#include "include/bits/core/functional.hpp"
 #include "include/bits/core/utils.hpp"
 
 #include "channel.hpp"
@@ -115,9 +122,9 @@ static int world_size() { return comm_size(MPI_COMM_WORLD); }
 ///
 ///@brief Free the given mpi-datatype, throws on failure in debug mode.
 ///
-///@param t type to free
+///@param t type to free, set to MPI_DATATYPE_NULL on return
 ///
-static void type_free(MPI_Datatype t) {
+static void type_free(MPI_Datatype& t) {
 
     int err = MPI_Type_free(&t);
     runtime_assert(err == MPI_SUCCESS, "MPI_Type_free fails");
@@ -128,7 +135,7 @@ static void type_free(MPI_Datatype t) {
 ///
 ///@param t datatype to commit
 ///
-static void type_commit(MPI_Datatype t) {
+static void type_commit(MPI_Datatype& t) {
 
     int err = MPI_Type_commit(&t);
     runtime_assert(err == MPI_SUCCESS, "MPI_Type_commit fails.");
@@ -151,16 +158,223 @@ static MPI_Datatype type_contiguous(int count, MPI_Datatype old_type) {
     return new_type;
 }
 
-template <class T> struct MakeDatatype {};
+///
+///@brief Creates a datatype describing an N-dimensional subarray of a row-major
+/// (C-ordered) array. The returned type is not committed.
+///
+///@param sizes the extent of the full array
+///@param subsizes the extent of the subarray
+///@param starts the starting indices of the subarray in the full array
+///@param old_type the element type of the array
+///@return MPI_Datatype a subarray datatype
+///
+template <size_t N>
+static MPI_Datatype type_create_subarray(std::array<int, N> sizes,
+                                         std::array<int, N> subsizes,
+                                         std::array<int, N> starts,
+                                         MPI_Datatype       old_type) {
+    MPI_Datatype new_type;
+
+    auto err = MPI_Type_create_subarray(int(N),
+                                        sizes.data(),
+                                        subsizes.data(),
+                                        starts.data(),
+                                        MPI_ORDER_C,
+                                        old_type,
+                                        &new_type);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Type_create_subarray fails.");
+    return new_type;
+}
 
-template <> struct MakeDatatype<int> {
+///
+///@brief Resizes the input datatype to have the given extent, throws on failure
+/// in debug mode. The returned type is not committed.
+///
+///@param old_type the type to resize
+///@param extent the new extent in bytes
+///@return MPI_Datatype the resized datatype
+///
+static MPI_Datatype type_create_resized(MPI_Datatype old_type,
+                                        MPI_Aint     extent) {
+    MPI_Datatype new_type;
 
-    MPI_Datatype operator()() { return MPI_INT; }
+    auto err = MPI_Type_create_resized(old_type, 0, extent, &new_type);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Type_create_resized fails.");
+    return new_type;
+}
+
+///
+///@brief Returns the size of the data described by the input datatype in
+/// bytes.
+///
+///@param t the datatype to query
+///@return int the size of the datatype
+///
+static int type_size(MPI_Datatype t) {
+    int size;
+    auto err = MPI_Type_size(t, &size);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Type_size fails.");
+    return size;
+}
+
+///
+///@brief Maps the type T to an mpi datatype. Arithmetic types and std::complex
+/// map to the predefined mpi types, std::array to a contiguous type of its
+/// element type and any other trivially copyable type to a contiguous block of
+/// bytes. The byte representation can only be transferred, so user defined
+/// aggregates which are reduced should specialize MakeDatatype, for example
+/// by inheriting from StructDatatype. Derived types are created and committed
+/// once on first use and live until MPI_Finalize.
+///
+///@tparam T the type to map
+///
+template <class T> struct MakeDatatype {
+
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable types can be sent with mpi");
+
+    MPI_Datatype operator()() const {
+        static MPI_Datatype t = [] {
+            auto ret = type_contiguous(int(sizeof(T)), MPI_BYTE);
+            type_commit(ret);
+            return ret;
+        }();
+        return t;
+    }
 };
 
-template <> struct MakeDatatype<size_t> {
+template <class T> struct MakeDatatype<const T> : MakeDatatype<T> {};
+
+// clang-format off
+template <> struct MakeDatatype<bool> { MPI_Datatype operator()() const { return MPI_CXX_BOOL; } };
+template <> struct MakeDatatype<char> { MPI_Datatype operator()() const { return MPI_CHAR; } };
+template <> struct MakeDatatype<signed char> { MPI_Datatype operator()() const { return MPI_SIGNED_CHAR; } };
+template <> struct MakeDatatype<unsigned char> { MPI_Datatype operator()() const { return MPI_UNSIGNED_CHAR; } };
+template <> struct MakeDatatype<wchar_t> { MPI_Datatype operator()() const { return MPI_WCHAR; } };
+template <> struct MakeDatatype<std::byte> { MPI_Datatype operator()() const { return MPI_BYTE; } };
+template <> struct MakeDatatype<short> { MPI_Datatype operator()() const { return MPI_SHORT; } };
+template <> struct MakeDatatype<unsigned short> { MPI_Datatype operator()() const { return MPI_UNSIGNED_SHORT; } };
+template <> struct MakeDatatype<int> { MPI_Datatype operator()() const { return MPI_INT; } };
+template <> struct MakeDatatype<unsigned> { MPI_Datatype operator()() const { return MPI_UNSIGNED; } };
+template <> struct MakeDatatype<long> { MPI_Datatype operator()() const { return MPI_LONG; } };
+template <> struct MakeDatatype<unsigned long> { MPI_Datatype operator()() const { return MPI_UNSIGNED_LONG; } };
+template <> struct MakeDatatype<long long> { MPI_Datatype operator()() const { return MPI_LONG_LONG; } };
+template <> struct MakeDatatype<unsigned long long> { MPI_Datatype operator()() const { return MPI_UNSIGNED_LONG_LONG; } };
+template <> struct MakeDatatype<float> { MPI_Datatype operator()() const { return MPI_FLOAT; } };
+template <> struct MakeDatatype<double> { MPI_Datatype operator()() const { return MPI_DOUBLE; } };
+template <> struct MakeDatatype<long double> { MPI_Datatype operator()() const { return MPI_LONG_DOUBLE; } };
+template <> struct MakeDatatype<std::complex<float>> { MPI_Datatype operator()() const { return MPI_CXX_FLOAT_COMPLEX; } };
+template <> struct MakeDatatype<std::complex<double>> { MPI_Datatype operator()() const { return MPI_CXX_DOUBLE_COMPLEX; } };
+template <> struct MakeDatatype<std::complex<long double>> { MPI_Datatype operator()() const { return MPI_CXX_LONG_DOUBLE_COMPLEX; } };
+// clang-format on
+
+template <class T, size_t M> struct MakeDatatype<std::array<T, M>> {
+
+    MPI_Datatype operator()() const {
+        static MPI_Datatype t = [] {
+            auto tmp = type_contiguous(int(M), MakeDatatype<T>{}());
+            auto ret =
+                type_create_resized(tmp, MPI_Aint(sizeof(std::array<T, M>)));
+            type_free(tmp);
+            type_commit(ret);
+            return ret;
+        }();
+        return t;
+    }
+};
+
+///
+///@brief Returns the address of the input location for use in datatype
+/// displacements relative to MPI_BOTTOM.
+///
+///@param location the location to query
+///@return MPI_Aint the address of the location
+///
+static MPI_Aint get_address(const void* location) {
+    MPI_Aint address;
+    auto     err = MPI_Get_address(location, &address);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Get_address fails.");
+    return address;
+}
+
+///
+///@brief Creates a struct datatype, throws on failure in debug mode. The
+/// returned type is not committed.
+///
+///@param lengths number of elements in each block
+///@param displacements byte displacement of each block
+///@param types the datatype of each block
+///@return MPI_Datatype the struct datatype
+///
+static MPI_Datatype
+type_create_struct(const std::vector<int>&          lengths,
+                   const std::vector<MPI_Aint>&     displacements,
+                   const std::vector<MPI_Datatype>& types) {
+
+    runtime_assert(lengths.size() == displacements.size() &&
+                       lengths.size() == types.size(),
+                   "Size mismatch in type_create_struct");
+
+    MPI_Datatype new_type;
+    auto         err = MPI_Type_create_struct(int(lengths.size()),
+                                      lengths.data(),
+                                      displacements.data(),
+                                      types.data(),
+                                      &new_type);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Type_create_struct fails.");
+    return new_type;
+}
+
+///
+///@brief Creates a struct datatype of the input data members of an aggregate.
+/// Each member is described by its own MakeDatatype and the extent of the
+/// returned type is sizeof(T) so that arrays of T are described correctly.
+/// The returned type is not committed.
+///
+///@param members pointers to the data members to include
+///@return MPI_Datatype the struct datatype
+///
+template <class T, class... Fields>
+static MPI_Datatype type_create_struct(Fields T::*... members) {
 
-    MPI_Datatype operator()() { return MPI_UNSIGNED_LONG; }
+    static_assert(std::is_default_constructible_v<T>,
+                  "type_create_struct requires a default constructible type");
+
+    const T obj{};
+    auto    offset = [&obj](auto member) {
+        return MPI_Aint(reinterpret_cast<const char*>(&(obj.*member)) -
+                        reinterpret_cast<const char*>(&obj));
+    };
+
+    auto tmp = type_create_struct(std::vector<int>(sizeof...(Fields), 1),
+                                  {offset(members)...},
+                                  {MakeDatatype<Fields>{}()...});
+
+    auto ret = type_create_resized(tmp, MPI_Aint(sizeof(T)));
+    type_free(tmp);
+    return ret;
+}
+
+///
+///@brief Helper for specializing MakeDatatype for aggregates, e.g.
+///
+/// template <> struct jada::mpi::MakeDatatype<State>
+///     : jada::mpi::StructDatatype<&State::rho, &State::u> {};
+///
+/// The struct type is created and committed once on first use.
+///
+///@tparam Members pointers to the data members to include
+///
+template <auto... Members> struct StructDatatype {
+
+    MPI_Datatype operator()() const {
+        static MPI_Datatype t = [] {
+            auto ret = type_create_struct(Members...);
+            type_commit(ret);
+            return ret;
+        }();
+        return t;
+    }
 };
 
 /// @brief Make a contiguous datatype for contiguous stl-like containers
@@ -258,6 +472,89 @@ static T all_sum_reduce(const T& local,
     return ret;
 }
 
+namespace detail {
+
+///
+///@brief Maps the binary operation Op to a predefined mpi operation. Only the
+/// standard function objects and Maximum/Minimum, which have a predefined mpi
+/// counterpart, are mapped.
+///
+template <class Op> struct PredefinedOp : std::false_type {};
+
+// clang-format off
+template <class T> struct PredefinedOp<std::plus<T>> : std::true_type { MPI_Op operator()() const { return MPI_SUM; } };
+template <class T> struct PredefinedOp<std::multiplies<T>> : std::true_type { MPI_Op operator()() const { return MPI_PROD; } };
+template <class T> struct PredefinedOp<std::logical_and<T>> : std::true_type { MPI_Op operator()() const { return MPI_LAND; } };
+template <class T> struct PredefinedOp<std::logical_or<T>> : std::true_type { MPI_Op operator()() const { return MPI_LOR; } };
+template <class T> struct PredefinedOp<std::bit_and<T>> : std::true_type { MPI_Op operator()() const { return MPI_BAND; } };
+template <class T> struct PredefinedOp<std::bit_or<T>> : std::true_type { MPI_Op operator()() const { return MPI_BOR; } };
+template <class T> struct PredefinedOp<std::bit_xor<T>> : std::true_type { MPI_Op operator()() const { return MPI_BXOR; } };
+template <> struct PredefinedOp<Maximum> : std::true_type { MPI_Op operator()() const { return MPI_MAX; } };
+template <> struct PredefinedOp<Minimum> : std::true_type { MPI_Op operator()() const { return MPI_MIN; } };
+// clang-format on
+
+///
+///@brief Returns a commutative mpi operation applying Op to elements of type
+/// T. The operation is created once on first use and lives until
+/// MPI_Finalize.
+///
+template <class T, class Op> static MPI_Op user_op() {
+
+    static MPI_Op op = [] {
+        auto apply = [](void* in, void* inout, int* len, MPI_Datatype*) {
+            const auto* lhs = static_cast<const T*>(in);
+            auto*       rhs = static_cast<T*>(inout);
+            for (int i = 0; i < *len; ++i) { rhs[i] = Op{}(lhs[i], rhs[i]); }
+        };
+        MPI_Op ret;
+        auto   err = MPI_Op_create(apply, 1, &ret);
+        runtime_assert(err == MPI_SUCCESS, "MPI_Op_create fails.");
+        return ret;
+    }();
+    return op;
+}
+
+} // namespace detail
+
+///
+///@brief Reduces the local values of all processes with the binary operation
+/// op and returns the result on _all processes_. Standard function objects
+/// with a predefined mpi operation (e.g. std::plus) are reduced with it,
+/// other stateless operations (e.g. captureless lambdas) with a user defined
+/// mpi operation. The operation should be associative and commutative.
+///
+///@param local the local value to reduce
+///@param op the binary reduction operation
+///@param communicator the mpi communicator (defaults to MPI_COMM_WORLD)
+///@return T the reduced value
+///
+template <class T, class BinaryOp>
+static T all_reduce(const T&  local,
+                    BinaryOp  op,
+                    MPI_Comm  communicator = MPI_COMM_WORLD) {
+
+    T               ret;
+    MakeDatatype<T> dt;
+
+    if constexpr (detail::PredefinedOp<BinaryOp>::value &&
+                  std::is_arithmetic_v<T>) {
+        (void)op;
+        detail::PredefinedOp<BinaryOp> mpi_op;
+        all_reduce(&local, &ret, 1, dt(), mpi_op(), communicator);
+    } else {
+        static_assert(std::is_default_constructible_v<BinaryOp>,
+                      "Only stateless operations can be used in all_reduce");
+        (void)op;
+        all_reduce(&local,
+                   &ret,
+                   1,
+                   dt(),
+                   detail::user_op<T, BinaryOp>(),
+                   communicator);
+    }
+    return ret;
+}
+
 ///
 ///@brief Gathers data from all processes to the recv_data buffer on the _root
 /// process_. This function assumes that all processes send an equal amount of
@@ -293,6 +590,25 @@ static void gather(const void*  send_data,
     runtime_assert(err == MPI_SUCCESS, "MPI_Gather fails");
 }
 
+///
+///@brief Broadcasts data from the root process to all processes, throws on
+/// failure in debug mode.
+///
+///@param data the buffer to send on root and to receive to on others
+///@param count number of elements in data
+///@param datatype the element type of data
+///@param root the process sending the data
+///@param communicator the mpi communicator (defaults to MPI_COMM_WORLD)
+///
+static void broadcast(void*        data,
+                      int          count,
+                      MPI_Datatype datatype,
+                      int          root,
+                      MPI_Comm     communicator = MPI_COMM_WORLD) {
+    auto err = MPI_Bcast(data, count, datatype, root, communicator);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Bcast fails.");
+}
+
 ///
 ///@brief Gathers data from all processes to _all processes_. This function
 /// assumes that all processes send an equal amount of data.
@@ -355,5 +671,352 @@ static void all_gatherv(const void*  send_data,
     runtime_assert(err == MPI_SUCCESS, "MPI_Allgather fails.");
 }
 
+///
+///@brief Starts a nonblocking send of the send_data buffer to the process
+/// dest, throws on failure in debug mode. The buffer may not be modified
+/// before the returned request has completed.
+///
+///@param send_data the buffer to send
+///@param count number of elements in the send_data
+///@param datatype the element type of the send_data
+///@param dest the rank of the receiving process
+///@param tag the message tag
+///@param communicator the mpi communicator (defaults to MPI_COMM_WORLD)
+///@return MPI_Request handle to the started send operation
+///
+static MPI_Request isend(const void*  send_data,
+                         int          count,
+                         MPI_Datatype datatype,
+                         int          dest,
+                         int          tag,
+                         MPI_Comm     communicator = MPI_COMM_WORLD) {
+    MPI_Request request;
+    auto        err = MPI_Isend(
+        send_data, count, datatype, dest, tag, communicator, &request);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Isend fails.");
+    return request;
+}
+
+///
+///@brief Starts a nonblocking receive of data from the process source into the
+/// recv_data buffer, throws on failure in debug mode. The buffer may not be
+/// accessed before the returned request has completed.
+///
+///@param recv_data the buffer to place the received data to
+///@param count number of elements in the recv_data
+///@param datatype the element type of the recv_data
+///@param source the rank of the sending process
+///@param tag the message tag
+///@param communicator the mpi communicator (defaults to MPI_COMM_WORLD)
+///@return MPI_Request handle to the started receive operation
+///
+static MPI_Request irecv(void*        recv_data,
+                         int          count,
+                         MPI_Datatype datatype,
+                         int          source,
+                         int          tag,
+                         MPI_Comm     communicator = MPI_COMM_WORLD) {
+    MPI_Request request;
+    auto        err = MPI_Irecv(
+        recv_data, count, datatype, source, tag, communicator, &request);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Irecv fails.");
+    return request;
+}
+
+///
+///@brief Creates a persistent send request, throws on failure in debug mode.
+/// The request is started with start_all() and has to be freed with
+/// request_free().
+///
+///@param send_data the buffer to send
+///@param count number of elements in the send_data
+///@param datatype the element type of the send_data
+///@param dest the rank of the receiving process
+///@param tag the message tag
+///@param communicator the mpi communicator (defaults to MPI_COMM_WORLD)
+///@return MPI_Request the inactive persistent request
+///
+static MPI_Request send_init(const void*  send_data,
+                             int          count,
+                             MPI_Datatype datatype,
+                             int          dest,
+                             int          tag,
+                             MPI_Comm     communicator = MPI_COMM_WORLD) {
+    MPI_Request request;
+    auto        err = MPI_Send_init(
+        send_data, count, datatype, dest, tag, communicator, &request);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Send_init fails.");
+    return request;
+}
+
+///
+///@brief Creates a persistent receive request, throws on failure in debug
+/// mode. The request is started with start_all() and has to be freed with
+/// request_free().
+///
+///@param recv_data the buffer to place the received data to
+///@param count number of elements in the recv_data
+///@param datatype the element type of the recv_data
+///@param source the rank of the sending process
+///@param tag the message tag
+///@param communicator the mpi communicator (defaults to MPI_COMM_WORLD)
+///@return MPI_Request the inactive persistent request
+///
+static MPI_Request recv_init(void*        recv_data,
+                             int          count,
+                             MPI_Datatype datatype,
+                             int          source,
+                             int          tag,
+                             MPI_Comm     communicator = MPI_COMM_WORLD) {
+    MPI_Request request;
+    auto        err = MPI_Recv_init(
+        recv_data, count, datatype, source, tag, communicator, &request);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Recv_init fails.");
+    return request;
+}
+
+///
+///@brief Starts all the input persistent requests, throws on failure in debug
+/// mode.
+///
+///@param requests the persistent requests to start
+///
+static void start_all(std::vector<MPI_Request>& requests) {
+    if (requests.empty()) { return; }
+    auto err =
+        MPI_Startall(static_cast<int>(requests.size()), requests.data());
+    runtime_assert(err == MPI_SUCCESS, "MPI_Startall fails.");
+}
+
+///
+///@brief Frees the input persistent request, throws on failure in debug mode.
+///
+///@param request the request to free
+///
+static void request_free(MPI_Request request) {
+    auto err = MPI_Request_free(&request);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Request_free fails.");
+}
+
+///
+///@brief Blocks until all the input requests have completed, throws on failure
+/// in debug mode. The completed requests are set to MPI_REQUEST_NULL.
+///
+///@param requests the requests to wait for
+///
+static void wait_all(std::vector<MPI_Request>& requests) {
+    auto err = MPI_Waitall(static_cast<int>(requests.size()),
+                           requests.data(),
+                           MPI_STATUSES_IGNORE);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Waitall fails.");
+}
+
+///
+///@brief Checks without blocking if all the input requests have completed,
+/// throws on failure in debug mode.
+///
+///@param requests the requests to test
+///@return true if all requests have completed, false otherwise
+///
+static bool test_all(std::vector<MPI_Request>& requests) {
+    int  flag;
+    auto err = MPI_Testall(static_cast<int>(requests.size()),
+                           requests.data(),
+                           &flag,
+                           MPI_STATUSES_IGNORE);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Testall fails.");
+    return flag != 0;
+}
+
+///
+///@brief Sends the send_data buffer to the process dest and blocks until the
+/// buffer can be reused, throws on failure in debug mode.
+///
+///@param send_data the buffer to send
+///@param count number of elements in the send_data
+///@param datatype the element type of the send_data
+///@param dest the rank of the receiving process
+///@param tag the message tag
+///@param communicator the mpi communicator (defaults to MPI_COMM_WORLD)
+///
+static void send(const void*  send_data,
+                 int          count,
+                 MPI_Datatype datatype,
+                 int          dest,
+                 int          tag,
+                 MPI_Comm     communicator = MPI_COMM_WORLD) {
+    auto err = MPI_Send(send_data, count, datatype, dest, tag, communicator);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Send fails.");
+}
+
+///
+///@brief Receives data from the process source into the recv_data buffer and
+/// blocks until the data has arrived, throws on failure in debug mode.
+///
+///@param recv_data the buffer to place the received data to
+///@param count number of elements in the recv_data
+///@param datatype the element type of the recv_data
+///@param source the rank of the sending process
+///@param tag the message tag
+///@param communicator the mpi communicator (defaults to MPI_COMM_WORLD)
+///
+static void recv(void*        recv_data,
+                 int          count,
+                 MPI_Datatype datatype,
+                 int          source,
+                 int          tag,
+                 MPI_Comm     communicator = MPI_COMM_WORLD) {
+    auto err = MPI_Recv(recv_data,
+                        count,
+                        datatype,
+                        source,
+                        tag,
+                        communicator,
+                        MPI_STATUS_IGNORE);
+    runtime_assert(err == MPI_SUCCESS, "MPI_Recv fails.");
+}
+
+///
+///@brief Collectively opens the file, throws on failure in debug mode.
+///
+///@param communicator the processes opening the file
+///@param filename the name of the file
+///@param amode the access mode, e.g. MPI_MODE_CREATE | MPI_MODE_WRONLY
+///@return MPI_File the file handle, closed with file_close()
+///
+static MPI_File
+file_open(MPI_Comm communicator, const std::string& filename, int amode) {
+    MPI_File fh;
+    auto     err = MPI_File_open(
+        communicator, filename.c_str(), amode, MPI_INFO_NULL, &fh);
+    runtime_assert(err == MPI_SUCCESS, "MPI_File_open fails.");
+    return fh;
+}
+
+///
+///@brief Collectively closes the file, throws on failure in debug mode.
+///
+///@param fh the file to close
+///
+static void file_close(MPI_File& fh) {
+    auto err = MPI_File_close(&fh);
+    runtime_assert(err == MPI_SUCCESS, "MPI_File_close fails.");
+}
+
+///
+///@brief Collectively resizes the file, throws on failure in debug mode.
+///
+///@param fh the file to resize
+///@param size the new size of the file in bytes
+///
+static void file_set_size(MPI_File fh, MPI_Offset size) {
+    auto err = MPI_File_set_size(fh, size);
+    runtime_assert(err == MPI_SUCCESS, "MPI_File_set_size fails.");
+}
+
+///
+///@brief Returns the size of the file in bytes, throws on failure in debug
+/// mode.
+///
+///@param fh the file handle
+///@return MPI_Offset the size of the file
+///
+static MPI_Offset file_get_size(MPI_File fh) {
+    MPI_Offset size = 0;
+    auto       err  = MPI_File_get_size(fh, &size);
+    runtime_assert(err == MPI_SUCCESS, "MPI_File_get_size fails.");
+    return size;
+}
+
+///
+///@brief Collectively sets the view of the calling process to the file, throws
+/// on failure in debug mode.
+///
+///@param fh the file handle
+///@param disp the displacement of the view in bytes from the file begin
+///@param etype the elementary datatype of the file
+///@param filetype the datatype describing the visible part of the file
+///
+static void file_set_view(MPI_File     fh,
+                          MPI_Offset   disp,
+                          MPI_Datatype etype,
+                          MPI_Datatype filetype) {
+    auto err = MPI_File_set_view(
+        fh, disp, etype, filetype, "native", MPI_INFO_NULL);
+    runtime_assert(err == MPI_SUCCESS, "MPI_File_set_view fails.");
+}
+
+///
+///@brief Collectively writes data to the current view of the file, throws on
+/// failure in debug mode.
+///
+///@param fh the file handle
+///@param data the buffer to write
+///@param count number of elements in data
+///@param datatype the element type of data
+///
+static void file_write_all(MPI_File     fh,
+                           const void*  data,
+                           int          count,
+                           MPI_Datatype datatype) {
+    auto err = MPI_File_write_all(fh, data, count, datatype, MPI_STATUS_IGNORE);
+    runtime_assert(err == MPI_SUCCESS, "MPI_File_write_all fails.");
+}
+
+///
+///@brief Writes data to the file at the given offset without synchronizing
+/// with the other processes, throws on failure in debug mode.
+///
+///@param fh the file handle
+///@param offset the offset in units of the etype of the current view
+///@param data the buffer to write
+///@param count number of elements in data
+///@param datatype the element type of data
+///
+static void file_write_at(MPI_File     fh,
+                          MPI_Offset   offset,
+                          const void*  data,
+                          int          count,
+                          MPI_Datatype datatype) {
+    auto err =
+        MPI_File_write_at(fh, offset, data, count, datatype, MPI_STATUS_IGNORE);
+    runtime_assert(err == MPI_SUCCESS, "MPI_File_write_at fails.");
+}
+
+///
+///@brief Reads data from the file at the given offset without synchronizing
+/// with the other processes, throws on failure in debug mode.
+///
+///@param fh the file handle
+///@param offset the offset in units of the etype of the current view
+///@param data the buffer to read to
+///@param count number of elements in data
+///@param datatype the element type of data
+///
+static void file_read_at(MPI_File     fh,
+                         MPI_Offset   offset,
+                         void*        data,
+                         int          count,
+                         MPI_Datatype datatype) {
+    auto err =
+        MPI_File_read_at(fh, offset, data, count, datatype, MPI_STATUS_IGNORE);
+    runtime_assert(err == MPI_SUCCESS, "MPI_File_read_at fails.");
+}
+
+///
+///@brief Collectively reads data from the current view of the file, throws on
+/// failure in debug mode.
+///
+///@param fh the file handle
+///@param data the buffer to read to
+///@param count number of elements in data
+///@param datatype the element type of data
+///
+static void
+file_read_all(MPI_File fh, void* data, int count, MPI_Datatype datatype) {
+    auto err = MPI_File_read_all(fh, data, count, datatype, MPI_STATUS_IGNORE);
+    runtime_assert(err == MPI_SUCCESS, "MPI_File_read_all fails.");
+}
+
 } // namespace mpi
 } // namespace jada
\ No newline at end of file
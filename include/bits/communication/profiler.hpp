@@ -0,0 +1,297 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gather.hpp"
+#include "mpi_functions.hpp"
+
+namespace jada {
+
+///
+///@brief The phases timed by the profiler.
+///
+enum class Phase : size_t {
+    Post,      // creating and starting the messages of an exchange
+    Pack,      // copying the sent slices to buffers
+    LocalCopy, // copying the transfers within a process
+    Wait,      // waiting for the messages of an exchange to complete
+    Unpack,    // copying the received buffers to the padding
+    Kernel,    // algorithms applied to distributed arrays
+    count
+};
+
+static constexpr std::array<const char*, size_t(Phase::count)> phase_names{
+    "post", "pack", "local_copy", "wait", "unpack", "kernel"};
+
+struct PhaseStats {
+    double seconds = 0.0; // accumulated wall time
+    size_t calls   = 0;   // number of timed scopes
+};
+
+struct NeighbourStats {
+    size_t bytes_sent        = 0;
+    size_t bytes_received    = 0;
+    size_t messages_sent     = 0;
+    size_t messages_received = 0;
+};
+
+///
+///@brief Accumulates the timings and communication volumes of the calling
+/// process. The data is only recorded if the library is compiled with
+/// JADA_ENABLE_PROFILING defined, otherwise the recording functions are empty
+/// and the profiler stays zero. Recording is not thread safe and is only done
+/// outside of the parallel regions of the library.
+///
+class Profiler {
+
+public:
+    void add_time(Phase phase, double seconds) {
+        auto& p = m_phases[size_t(phase)];
+        p.seconds += seconds;
+        p.calls++;
+    }
+
+    void add_sent(int peer, size_t bytes) {
+        auto& n = m_neighbours[peer];
+        n.bytes_sent += bytes;
+        n.messages_sent++;
+    }
+
+    void add_received(int peer, size_t bytes) {
+        auto& n = m_neighbours[peer];
+        n.bytes_received += bytes;
+        n.messages_received++;
+    }
+
+    void reset() {
+        m_phases = {};
+        m_neighbours.clear();
+    }
+
+    const auto& phases() const { return m_phases; }
+    const auto& neighbours() const { return m_neighbours; }
+
+private:
+    std::array<PhaseStats, size_t(Phase::count)> m_phases{};
+    std::map<int, NeighbourStats>                m_neighbours;
+};
+
+///
+///@brief Returns the profiler of the calling process.
+///
+///@return Profiler& the process-wide profiler
+///
+inline Profiler& profiler() {
+    static Profiler p;
+    return p;
+}
+
+#ifdef JADA_ENABLE_PROFILING
+
+static constexpr bool profiling_enabled = true;
+
+///
+///@brief Adds the wall time between construction and destruction to the
+/// given phase of the profiler.
+///
+class ScopedTimer {
+    using clock = std::chrono::steady_clock;
+
+public:
+    explicit ScopedTimer(Phase phase)
+        : m_phase(phase)
+        , m_start(clock::now()) {}
+
+    ScopedTimer(const ScopedTimer&)            = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer() {
+        std::chrono::duration<double> elapsed = clock::now() - m_start;
+        profiler().add_time(m_phase, elapsed.count());
+    }
+
+private:
+    Phase             m_phase;
+    clock::time_point m_start;
+};
+
+///
+///@brief Records a message of 'bytes' bytes sent to 'peer'.
+///
+inline void record_sent(int peer, size_t bytes) {
+    profiler().add_sent(peer, bytes);
+}
+
+///
+///@brief Records a message of 'bytes' bytes received from 'peer'.
+///
+inline void record_received(int peer, size_t bytes) {
+    profiler().add_received(peer, bytes);
+}
+
+#else
+
+static constexpr bool profiling_enabled = false;
+
+class ScopedTimer {
+public:
+    explicit constexpr ScopedTimer([[maybe_unused]] Phase phase) {}
+};
+
+constexpr void record_sent([[maybe_unused]] int    peer,
+                           [[maybe_unused]] size_t bytes) {}
+
+constexpr void record_received([[maybe_unused]] int    peer,
+                               [[maybe_unused]] size_t bytes) {}
+
+#endif
+
+enum class ReportFormat { Csv, Json };
+
+namespace detail {
+
+///
+///@brief Per-phase statistics over all the processes.
+///
+struct PhaseSummary {
+    double min  = 0.0;
+    double max  = 0.0;
+    double mean = 0.0;
+
+    // max / mean, 1 for perfectly balanced phases
+    double imbalance() const { return mean > 0.0 ? max / mean : 1.0; }
+};
+
+inline PhaseSummary summarize(const std::vector<double>& per_rank) {
+    PhaseSummary ret;
+    if (per_rank.empty()) { return ret; }
+    ret.min = *std::min_element(per_rank.begin(), per_rank.end());
+    ret.max = *std::max_element(per_rank.begin(), per_rank.end());
+    for (auto t : per_rank) { ret.mean += t; }
+    ret.mean /= double(per_rank.size());
+    return ret;
+}
+
+} // namespace detail
+
+///
+///@brief Collects the profiler data of all the processes and formats a report
+/// with the per-rank phase timings, the per-rank neighbour communication
+/// volumes and an aggregated summary of each phase (min, max, mean and load
+/// imbalance max/mean over the ranks). This is a collective call and the same
+/// report is returned on all the processes.
+///
+///@param format Csv or Json
+///@param comm the mpi communicator (defaults to MPI_COMM_WORLD)
+///@return std::string the formatted report
+///
+inline std::string profile_report(ReportFormat format = ReportFormat::Csv,
+                                  MPI_Comm     comm   = MPI_COMM_WORLD) {
+
+    constexpr size_t n_phases    = size_t(Phase::count);
+    constexpr size_t n_neighbour = 6;
+    const auto       n_ranks     = size_t(mpi::comm_size(comm));
+    const auto&      local       = profiler();
+
+    std::vector<double> seconds;
+    std::vector<size_t> calls;
+    for (const auto& p : local.phases()) {
+        seconds.push_back(p.seconds);
+        calls.push_back(p.calls);
+    }
+
+    std::vector<size_t> neighbours;
+    for (const auto& [peer, n] : local.neighbours()) {
+        neighbours.insert(neighbours.end(),
+                          {size_t(mpi::get_rank(comm)),
+                           size_t(peer),
+                           n.bytes_sent,
+                           n.bytes_received,
+                           n.messages_sent,
+                           n.messages_received});
+    }
+
+    const auto all_seconds    = all_gather(seconds, comm);
+    const auto all_calls      = all_gather(calls, comm);
+    const auto all_neighbours = all_gather(neighbours, comm);
+
+    std::vector<detail::PhaseSummary> summaries;
+    for (size_t p = 0; p < n_phases; ++p) {
+        std::vector<double> per_rank;
+        for (size_t r = 0; r < n_ranks; ++r) {
+            per_rank.push_back(all_seconds[r * n_phases + p]);
+        }
+        summaries.push_back(detail::summarize(per_rank));
+    }
+
+    std::stringstream ss;
+
+    if (format == ReportFormat::Csv) {
+
+        ss << "rank,phase,seconds,calls\n";
+        for (size_t r = 0; r < n_ranks; ++r) {
+            for (size_t p = 0; p < n_phases; ++p) {
+                ss << r << "," << phase_names[p] << ","
+                   << all_seconds[r * n_phases + p] << ","
+                   << all_calls[r * n_phases + p] << "\n";
+            }
+        }
+
+        ss << "\nrank,peer,bytes_sent,bytes_received,messages_sent,"
+              "messages_received\n";
+        for (size_t i = 0; i < all_neighbours.size(); i += n_neighbour) {
+            for (size_t j = 0; j < n_neighbour; ++j) {
+                ss << all_neighbours[i + j]
+                   << (j + 1 < n_neighbour ? "," : "\n");
+            }
+        }
+
+        ss << "\nphase,min,max,mean,imbalance\n";
+        for (size_t p = 0; p < n_phases; ++p) {
+            const auto& s = summaries[p];
+            ss << phase_names[p] << "," << s.min << "," << s.max << ","
+               << s.mean << "," << s.imbalance() << "\n";
+        }
+        return ss.str();
+    }
+
+    ss << "{\n  \"ranks\": [\n";
+    for (size_t r = 0; r < n_ranks; ++r) {
+        ss << "    {\"rank\": " << r << ", \"phases\": {";
+        for (size_t p = 0; p < n_phases; ++p) {
+            ss << "\"" << phase_names[p]
+               << "\": {\"seconds\": " << all_seconds[r * n_phases + p]
+               << ", \"calls\": " << all_calls[r * n_phases + p] << "}"
+               << (p + 1 < n_phases ? ", " : "");
+        }
+        ss << "}}" << (r + 1 < n_ranks ? "," : "") << "\n";
+    }
+    ss << "  ],\n  \"neighbours\": [\n";
+    for (size_t i = 0; i < all_neighbours.size(); i += n_neighbour) {
+        ss << "    {\"rank\": " << all_neighbours[i]
+           << ", \"peer\": " << all_neighbours[i + 1]
+           << ", \"bytes_sent\": " << all_neighbours[i + 2]
+           << ", \"bytes_received\": " << all_neighbours[i + 3]
+           << ", \"messages_sent\": " << all_neighbours[i + 4]
+           << ", \"messages_received\": " << all_neighbours[i + 5] << "}"
+           << (i + n_neighbour < all_neighbours.size() ? "," : "") << "\n";
+    }
+    ss << "  ],\n  \"summary\": {\n";
+    for (size_t p = 0; p < n_phases; ++p) {
+        const auto& s = summaries[p];
+        ss << "    \"" << phase_names[p] << "\": {\"min\": " << s.min
+           << ", \"max\": " << s.max << ", \"mean\": " << s.mean
+           << ", \"imbalance\": " << s.imbalance() << "}"
+           << (p + 1 < n_phases ? "," : "") << "\n";
+    }
+    ss << "  }\n}\n";
+    return ss.str();
+}
+
+} // namespace jada
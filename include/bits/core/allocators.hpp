@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#endif
+
+#ifndef JADA_ALIGNMENT
+// Alignment in bytes of the storage of distributed arrays (a cache line)
+#define JADA_ALIGNMENT 64
+#endif
+
+#ifndef JADA_HUGE_PAGE_BYTES
+// Size of a transparent huge page
+#define JADA_HUGE_PAGE_BYTES (2 * 1024 * 1024)
+#endif
+
+namespace jada {
+
+///
+///@brief Allocator returning memory aligned to 'Alignment' bytes.
+///
+///@tparam T the element type
+///@tparam Alignment the alignment in bytes, a power of two
+///
+template <class T, size_t Alignment = JADA_ALIGNMENT> struct AlignedAllocator {
+
+    static_assert((Alignment & (Alignment - 1)) == 0,
+                  "Alignment has to be a power of two");
+
+    using value_type      = T;
+    using is_always_equal = std::true_type;
+
+    template <class U> struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    static constexpr std::align_val_t alignment{
+        Alignment < alignof(T) ? alignof(T) : Alignment};
+
+    AlignedAllocator() = default;
+
+    template <class U>
+    constexpr AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), alignment));
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        ::operator delete(p, alignment);
+    }
+
+    template <class U>
+    constexpr bool operator==(const AlignedAllocator<U, Alignment>&) const {
+        return true;
+    }
+};
+
+///
+///@brief Allocator placing allocations of at least a huge page on huge page
+/// boundaries and advising the kernel to back them with transparent huge
+/// pages, which reduces the TLB misses when streaming through large arrays.
+/// Smaller allocations are aligned to JADA_ALIGNMENT bytes.
+///
+///@tparam T the element type
+///
+template <class T> struct HugePageAllocator {
+
+    using value_type      = T;
+    using is_always_equal = std::true_type;
+
+    template <class U> struct rebind {
+        using other = HugePageAllocator<U>;
+    };
+
+    HugePageAllocator() = default;
+
+    template <class U>
+    constexpr HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        const size_t bytes = rounded_size(n);
+        void*        p     = ::operator new(bytes, alignment(n));
+#ifdef MADV_HUGEPAGE
+        if (bytes >= JADA_HUGE_PAGE_BYTES) { madvise(p, bytes, MADV_HUGEPAGE); }
+#endif
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        ::operator delete(p, alignment(n));
+    }
+
+    template <class U>
+    constexpr bool operator==(const HugePageAllocator<U>&) const {
+        return true;
+    }
+
+private:
+    static constexpr bool huge(size_t n) {
+        return n * sizeof(T) >= JADA_HUGE_PAGE_BYTES;
+    }
+
+    static constexpr size_t rounded_size(size_t n) {
+        const size_t bytes = n * sizeof(T);
+        if (!huge(n)) { return bytes; }
+        return (bytes + JADA_HUGE_PAGE_BYTES - 1) / JADA_HUGE_PAGE_BYTES *
+               JADA_HUGE_PAGE_BYTES;
+    }
+
+    static constexpr std::align_val_t alignment(size_t n) {
+        if (huge(n)) { return std::align_val_t{JADA_HUGE_PAGE_BYTES}; }
+        return std::align_val_t{
+            JADA_ALIGNMENT < alignof(T) ? alignof(T) : JADA_ALIGNMENT};
+    }
+};
+
+///
+///@brief Allocator adaptor which default-initializes the elements constructed
+/// without arguments instead of value-initializing them. Resizing a
+/// std::vector with it leaves trivial elements uninitialized, so that the
+/// pages are first touched by whoever writes them first.
+///
+///@tparam T the element type
+///@tparam Allocator the adapted allocator
+///
+template <class T, class Allocator = AlignedAllocator<T>>
+struct DefaultInitAllocator : Allocator {
+
+    using value_type = T;
+
+    template <class U> struct rebind {
+        using other = DefaultInitAllocator<
+            U,
+            typename std::allocator_traits<Allocator>::template rebind_alloc<
+                U>>;
+    };
+
+    DefaultInitAllocator() = default;
+
+    DefaultInitAllocator(const Allocator& alloc) noexcept
+        : Allocator(alloc) {}
+
+    template <class U, class A>
+    DefaultInitAllocator(const DefaultInitAllocator<U, A>& other) noexcept
+        : Allocator(static_cast<const A&>(other)) {}
+
+    template <class U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+        ::new (static_cast<void*>(p)) U;
+    }
+
+    template <class U, class... Args> void construct(U* p, Args&&... args) {
+        std::allocator_traits<Allocator>::construct(
+            static_cast<Allocator&>(*this), p, std::forward<Args>(args)...);
+    }
+};
+
+} // namespace jada
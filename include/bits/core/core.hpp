@@ -1,13 +1,15 @@
 #pragma once
 
-
+#include "allocators.hpp"
 #include "cartesian_product.hpp"
 #include "counting_iterator.hpp"
 #include "extents.hpp"
+#include "functional.hpp"
 #include "index_conversions.hpp"
 #include "indices.hpp"
 #include "integer_types.hpp"
 #include "loop.hpp"
+#include "mapped_file.hpp"
 #include "mdspan.hpp"
 #include "min_max_offset.hpp"
 #include "rank.hpp"
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <algorithm>
+
+namespace jada {
+
+///
+///@brief Returns its argument unchanged.
+///
+struct Identity {
+    template <class T> constexpr T operator()(const T& v) const { return v; }
+};
+
+///
+///@brief Returns the larger of the two arguments.
+///
+struct Maximum {
+    template <class T> constexpr T operator()(const T& lhs, const T& rhs) const {
+        return std::max(lhs, rhs);
+    }
+};
+
+///
+///@brief Returns the smaller of the two arguments.
+///
+struct Minimum {
+    template <class T> constexpr T operator()(const T& lhs, const T& rhs) const {
+        return std::min(lhs, rhs);
+    }
+};
+
+} // namespace jada
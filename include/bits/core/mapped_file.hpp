@@ -0,0 +1,148 @@
+#pragma once
+
+#if __has_include(<sys/mman.h>)
+
+#include <algorithm>
+#include <cstddef>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+
+namespace jada {
+
+///
+///@brief A read-only contiguous container of elements mapped from a file with
+/// mmap. The pages of the file are loaded lazily on first access, so creating
+/// the mapping is cheap and a process reading only a part of the elements
+/// touches only the pages holding that part. Models the contiguous container
+/// interface (value_type, data(), size()) so that make_span, make_subspans and
+/// distribute work directly over the mapping, e.g.
+///
+/// MappedFile<double> file("field.bin");
+/// auto spans = make_subspans(file, topo, rank);
+///
+///@tparam T the element type, has to be trivially copyable
+///
+template <class T> class MappedFile {
+
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Only trivially copyable elements can be mapped");
+
+public:
+    using value_type     = T;
+    using size_type      = size_t;
+    using const_iterator = const T*;
+
+    ///
+    ///@brief Maps count elements of the file starting at offset bytes from
+    /// the beginning of the file. Throws std::runtime_error if the file can
+    /// not be opened or mapped, if the offset is beyond the end of the file or
+    /// if the offset is not a multiple of alignof(T).
+    ///
+    ///@param filename the name of the file
+    ///@param offset the offset of the first element in bytes
+    ///@param count the number of elements to map, defaults to all remaining
+    /// complete elements of the file
+    ///
+    explicit MappedFile(const std::string& filename,
+                        size_t             offset = 0,
+                        size_t             count  = size_t(-1)) {
+
+        if (offset % alignof(T) != 0) {
+            throw std::runtime_error("Misaligned offset in MappedFile");
+        }
+
+        const int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Could not open the file to map: " +
+                                     filename);
+        }
+
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Could not stat the file to map: " +
+                                     filename);
+        }
+        const auto file_size = size_t(st.st_size);
+
+        if (offset > file_size) {
+            ::close(fd);
+            throw std::runtime_error("Mapping offset beyond the file: " +
+                                     filename);
+        }
+        m_size = std::min(count, (file_size - offset) / sizeof(T));
+
+        // mmap requires a page aligned offset
+        const auto page  = size_t(::sysconf(_SC_PAGESIZE));
+        const auto begin = offset / page * page;
+        m_length         = offset - begin + m_size * sizeof(T);
+
+        if (m_size > 0) {
+            m_mapping = ::mmap(
+                nullptr, m_length, PROT_READ, MAP_SHARED, fd, off_t(begin));
+        }
+        ::close(fd);
+
+        if (m_mapping == MAP_FAILED) {
+            m_mapping = nullptr;
+            throw std::runtime_error("Could not map the file: " + filename);
+        }
+
+        if (m_mapping) {
+            m_data = reinterpret_cast<const T*>(
+                static_cast<const std::byte*>(m_mapping) + (offset - begin));
+        }
+    }
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+        : m_mapping(std::exchange(other.m_mapping, nullptr))
+        , m_length(std::exchange(other.m_length, 0))
+        , m_data(std::exchange(other.m_data, nullptr))
+        , m_size(std::exchange(other.m_size, 0)) {}
+
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+            m_length  = std::exchange(other.m_length, 0);
+            m_data    = std::exchange(other.m_data, nullptr);
+            m_size    = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile() { unmap(); }
+
+    const T* data() const { return m_data; }
+    size_t   size() const { return m_size; }
+    bool     empty() const { return m_size == 0; }
+
+    const T* begin() const { return m_data; }
+    const T* end() const { return m_data + m_size; }
+
+    const T& operator[](size_t i) const { return m_data[i]; }
+
+private:
+    void*    m_mapping = nullptr;
+    size_t   m_length  = 0;
+    const T* m_data    = nullptr;
+    size_t   m_size    = 0;
+
+    void unmap() {
+        if (m_mapping) { ::munmap(m_mapping, m_length); }
+        m_mapping = nullptr;
+    }
+};
+
+} // namespace jada
+
+#endif
@@ -39,7 +39,8 @@ template <class Span> static constexpr auto dimensions(const Span& span) {
 /// @return a multi-dimensional span
 template <class Container, class Dims>
 static constexpr auto make_span(Container& c, Dims dims) {
-    using value_type = typename Container::value_type;
+    // Read-only containers return a pointer to const also when non-const
+    using value_type = std::remove_pointer_t<decltype(std::data(c))>;
     auto ext         = make_extent(dims);
     runtime_assert(flat_size(ext) == std::size(c),
                    "Dimension mismatch in make_span");
@@ -54,7 +55,8 @@ static constexpr auto make_span(Container& c, Dims dims) {
 /// @return a multi-dimensional span
 template <class Container, class Dims>
 static constexpr auto make_span(const Container& c, Dims dims) {
-    using value_type = const typename Container::value_type;
+    // Views (e.g. std::span<T>) do not propagate their constness
+    using value_type = std::remove_pointer_t<decltype(std::data(c))>;
     auto ext         = make_extent(dims);
     runtime_assert(flat_size(ext) == std::size(c),
                    "Dimension mismatch in make_span");
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <array>
+#include <functional>
 #include <iterator>
 
+#include "integer_types.hpp"
+
 namespace jada {
 
 struct Tester {
@@ -30,6 +33,39 @@ static constexpr auto min_max_offset(auto op) {
     return std::make_pair(t.min(), t.max());
 }
 
+template <size_t N> struct MdTester {
+
+    std::array<index_type, N> m_max{};
+    std::array<index_type, N> m_min{};
+
+    template <class... Is> constexpr auto operator()(Is... is) {
+
+        static_assert(sizeof...(Is) == N, "Rank mismatch in MdTester");
+
+        const std::array<index_type, N> idx{index_type(is)...};
+        for (size_t i = 0; i < N; ++i) {
+            if (idx[i] >= m_max[i]) { m_max[i] = idx[i]; }
+            if (idx[i] < m_min[i]) { m_min[i] = idx[i]; }
+        }
+        return 1;
+    }
+
+    constexpr auto max() const { return m_max; }
+    constexpr auto min() const { return m_min; }
+};
+
+/// @brief Multidimensional version of min_max_offset for window operations.
+/// @tparam N the rank of the window accessor given to op
+/// @param op the window operation to query the offsets of
+/// @return a pair of arrays holding the minimum and maximum offsets op accesses
+/// in each direction
+template <size_t N> static constexpr auto md_min_max_offset(auto op) {
+    MdTester<N>                         t;
+    std::reference_wrapper<MdTester<N>> tt(t);
+    op(tt);
+    return std::make_pair(t.min(), t.max());
+}
+
 
 
 
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "include/bits/core/loop.hpp"
+#include "include/bits/core/utils.hpp"
+#include "topology.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace jada {
+
+///
+///@brief Options of the recursive bisection decomposition.
+///
+struct BisectionOptions {
+
+    // The accepted relative overload of the heavier side of a single cut
+    // with respect to its share of the weight. With minimize_surface, any cut
+    // within the tolerance (or as good as the best cut) is accepted and the
+    // one with the smallest area is chosen.
+    double tolerance = 0.02;
+
+    // If true, cut along the direction which yields the smallest new halo
+    // surface among the sufficiently balanced cuts, otherwise cut along the
+    // direction which yields the best balance.
+    bool minimize_surface = true;
+};
+
+///
+///@brief Weight function giving every cell the same weight.
+///
+struct UniformWeight {
+    template <class Idx> constexpr double operator()(const Idx&) const {
+        return 1.0;
+    }
+};
+
+namespace detail {
+
+///
+///@brief Returns the weight profiles of the box along each direction, i.e.
+/// profile[d][k] is the total weight of the cells of the box whose index in
+/// direction d is box.begin[d] + k.
+///
+template <size_t N, class WeightFunction>
+static inline std::array<std::vector<double>, N>
+weight_profiles(const Box<N>& box, const WeightFunction& weight) {
+
+    std::array<std::vector<double>, N> ret;
+    const auto dims = extent_to_array(box.get_extent());
+
+    if constexpr (std::is_same_v<WeightFunction, UniformWeight>) {
+        for (size_t d = 0; d < N; ++d) {
+            const double slab = double(box.size()) / double(dims[d]);
+            ret[d].assign(dims[d], slab);
+        }
+    } else {
+        for (size_t d = 0; d < N; ++d) { ret[d].assign(dims[d], 0.0); }
+
+        for (auto md_idx : md_indices(box.begin, box.end)) {
+            const auto   idx = tuple_to_array(md_idx);
+            const double w   = double(weight(idx));
+            for (size_t d = 0; d < N; ++d) {
+                ret[d][size_t(idx[d] - box.begin[d])] += w;
+            }
+        }
+    }
+    return ret;
+}
+
+///
+///@brief A candidate cut of a box at index 'position' along 'dir'.
+///
+struct BisectionCut {
+    size_t     dir;
+    index_type position;
+    int        n_left;    // ranks assigned to the lower side
+    double     imbalance; // relative overload of the heavier side
+    size_t     area;      // cell count of the cut face
+};
+
+///
+///@brief Recursively bisects 'box' for the ranks [first_rank, first_rank +
+/// n_ranks) and appends the resulting boxes to 'out'. The ranks are split in
+/// halves unless a side of the cut has fewer cells than its half of the ranks,
+/// in which case the split moves ranks to the other side. Hence any box with
+/// at least n_ranks cells can be decomposed.
+///
+template <size_t N, class WeightFunction>
+static inline void bisect(const Box<N>&                box,
+                          int                          first_rank,
+                          int                          n_ranks,
+                          const WeightFunction&        weight,
+                          const BisectionOptions&      opts,
+                          std::vector<BoxRankPair<N>>& out) {
+
+    if (n_ranks == 1) {
+        out.push_back(BoxRankPair<N>(box, first_rank));
+        return;
+    }
+
+    const auto n        = size_t(n_ranks);
+    const auto dims     = extent_to_array(box.get_extent());
+    const auto profiles = weight_profiles(box, weight);
+
+    std::vector<BisectionCut> cuts;
+    for (size_t d = 0; d < N; ++d) {
+
+        const auto&  p     = profiles[d];
+        const size_t area  = box.size() / dims[d];
+        double       total = 0;
+        for (auto w : p) { total += w; }
+
+        BisectionCut best{d, 0, 0, std::numeric_limits<double>::max(), area};
+        double       left = 0;
+        for (size_t k = 1; k < dims[d]; ++k) {
+            left += p[k - 1];
+
+            // Both sides need at least one cell per rank, such a split exists
+            // since the box has at least n cells
+            const size_t l_cells = k * area;
+            const size_t r_cells = (dims[d] - k) * area;
+            const size_t lo      = r_cells >= n ? 1 : n - r_cells;
+            const size_t hi      = std::min(l_cells, n - 1);
+            const size_t n_left  = std::clamp(n / 2, lo, hi);
+
+            // Overload of the heavier side with respect to its share
+            const double target = total * double(n_left) / double(n);
+            const double imbalance =
+                total > 0 ? std::max(left / target,
+                                     (total - left) / (total - target)) -
+                                1.0
+                          : 0.0;
+            if (imbalance < best.imbalance) {
+                best.position  = box.begin[d] + index_type(k);
+                best.n_left    = int(n_left);
+                best.imbalance = imbalance;
+            }
+        }
+        if (best.imbalance != std::numeric_limits<double>::max()) {
+            cuts.push_back(best);
+        }
+    }
+
+    runtime_assert(!cuts.empty(), "Box too small to bisect");
+
+    double best_imbalance = std::numeric_limits<double>::max();
+    for (const auto& c : cuts) {
+        best_imbalance = std::min(best_imbalance, c.imbalance);
+    }
+
+    auto better = [&](const BisectionCut& lhs, const BisectionCut& rhs) {
+        if (opts.minimize_surface) {
+            const double accept = std::max(opts.tolerance, best_imbalance);
+            const bool   l_ok   = lhs.imbalance <= accept;
+            const bool   r_ok   = rhs.imbalance <= accept;
+            if (l_ok != r_ok) { return l_ok; }
+            if (lhs.area != rhs.area) { return lhs.area < rhs.area; }
+            return lhs.imbalance < rhs.imbalance;
+        }
+        if (lhs.imbalance != rhs.imbalance) {
+            return lhs.imbalance < rhs.imbalance;
+        }
+        return lhs.area < rhs.area;
+    };
+
+    BisectionCut cut = cuts.front();
+    for (const auto& c : cuts) {
+        if (better(c, cut)) { cut = c; }
+    }
+
+    auto left_box            = box;
+    auto right_box           = box;
+    left_box.end[cut.dir]    = cut.position;
+    right_box.begin[cut.dir] = cut.position;
+
+    bisect(left_box, first_rank, cut.n_left, weight, opts, out);
+    bisect(right_box,
+           first_rank + cut.n_left,
+           n_ranks - cut.n_left,
+           weight,
+           opts,
+           out);
+}
+
+} // namespace detail
+
+///
+///@brief Decomposes the domain for n_ranks processes with recursive coordinate
+/// bisection. The box of each subtree is cut in two parts whose weights are
+/// proportional to the number of ranks of the subtrees, so that every rank
+/// count (not only ones with convenient factors) gives near-equal loads. By
+/// default the cut direction is chosen to minimize the new halo surface among
+/// the balanced cuts, see BisectionOptions.
+///
+///@param domain the domain to decompose
+///@param n_ranks the number of processes, each gets exactly one box. Any count
+/// from 1 to domain.size() is valid, otherwise std::runtime_error is thrown
+///@param periods the periodicity of the domain in each direction
+///@param weight function object returning the cost of the cell at the given
+/// global index (std::array<index_type, N>), e.g. to account for costlier
+/// regions. Defaults to a uniform weight.
+///@param opts the options of the bisection
+///@return Topology<N> the decomposed topology
+///
+template <size_t N, class WeightFunction = UniformWeight>
+Topology<N> decompose_bisection(Box<N>              domain,
+                                int                 n_ranks,
+                                std::array<bool, N> periods,
+                                WeightFunction      weight = {},
+                                BisectionOptions    opts   = {}) {
+
+    if (n_ranks <= 0 || domain.size() < size_t(n_ranks)) {
+        throw std::runtime_error(
+            "decompose_bisection requires 0 < n_ranks <= domain.size()");
+    }
+
+    std::vector<BoxRankPair<N>> boxes;
+    boxes.reserve(size_t(n_ranks));
+    detail::bisect(domain, 0, n_ranks, weight, opts, boxes);
+
+    auto ret = Topology<N>(domain, boxes, periods);
+    runtime_assert(ret.is_valid(), "Invalid topology.");
+
+    return ret;
+}
+
+///
+///@brief Decomposes the domain for n_ranks processes with recursive coordinate
+/// bisection using uniform weights.
+///
+///@param domain the domain to decompose
+///@param n_ranks the number of processes, each gets exactly one box
+///@param periods the periodicity of the domain in each direction
+///@param opts the options of the bisection
+///@return Topology<N> the decomposed topology
+///
+template <size_t N>
+Topology<N> decompose_bisection(Box<N>              domain,
+                                int                 n_ranks,
+                                std::array<bool, N> periods,
+                                BisectionOptions    opts) {
+    return decompose_bisection(
+        domain, n_ranks, periods, UniformWeight{}, opts);
+}
+
+} // namespace jada
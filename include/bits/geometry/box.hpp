@@ -224,4 +224,36 @@ template <size_t N> Box<N> expand(const Box<N>& box, index_type thickness) {
     return expand(box, thick, thick);
 }
 
+///
+///@brief Splits the region covered by 'outer' but not by 'inner' into at most
+/// 2*N non-overlapping boxes. Assumes that inner is fully inside outer.
+///
+///@param outer the box to subtract from
+///@param inner the box to subtract
+///@return std::vector<Box<N>> non-empty boxes covering outer minus inner
+///
+template <size_t N>
+std::vector<Box<N>> difference(const Box<N>& outer, const Box<N>& inner) {
+
+    std::vector<Box<N>> ret;
+
+    auto remaining = outer;
+    for (size_t i = 0; i < N; ++i) {
+
+        auto lower   = remaining;
+        lower.end[i] = inner.begin[i];
+
+        auto upper     = remaining;
+        upper.begin[i] = inner.end[i];
+
+        if (lower.is_valid() && volume(lower) > 0) { ret.push_back(lower); }
+        if (upper.is_valid() && volume(upper) > 0) { ret.push_back(upper); }
+
+        remaining.begin[i] = inner.begin[i];
+        remaining.end[i]   = inner.end[i];
+    }
+
+    return ret;
+}
+
 } // namespace jada
\ No newline at end of file
@@ -5,4 +5,5 @@
 #include "neighbours.hpp"
 #include "divide_equally.hpp"
 #include "decomposition.hpp"
+#include "bisection.hpp"
 #include "topology.hpp"
\ No newline at end of file
@@ -296,7 +296,7 @@ std::ostream& operator<<(std::ostream& os, const Topology<L>& topo) {
 template <size_t N, class Data>
 auto make_subspans(Data& data, const Topology<N>& topo, int rank) {
 
-    using T      = typename Data::value_type;
+    using T      = std::remove_pointer_t<decltype(std::data(data))>;
     using span_t = span_base<T, N, stdex::layout_stride>;
     std::vector<span_t> ret;
     auto bigspan = make_span(data, topo.get_domain().get_extent());
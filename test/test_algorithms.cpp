@@ -121,6 +121,34 @@ TEST_CASE("algorithms"){
 
     }
 
+    SECTION("md_for_each"){
+
+        auto visit = [](auto policy, auto begin, auto end){
+            std::vector<int> visited(3 * 4 * 5, 0);
+            auto F = [&](auto idx){
+                visited[size_t(idx[0] * 20 + idx[1] * 5 + idx[2])] += 1;
+            };
+            detail::md_for_each(policy, md_indices(begin, end), F);
+            return visited;
+        };
+
+        std::array<index_type, 3> begin{1, 0, 2};
+        std::array<index_type, 3> end{3, 4, 5};
+
+        std::vector<int> correct(3 * 4 * 5, 0);
+        for (index_type k = begin[0]; k < end[0]; ++k){
+        for (index_type j = begin[1]; j < end[1]; ++j){
+        for (index_type i = begin[2]; i < end[2]; ++i){
+            correct[size_t(k * 20 + j * 5 + i)] = 1;
+        }}}
+
+        CHECK(visit(std::execution::seq, begin, end) == correct);
+        CHECK(visit(std::execution::par, begin, end) == correct);
+
+        std::array<index_type, 3> empty{1, 4, 2};
+        CHECK(visit(std::execution::seq, begin, empty) == std::vector<int>(3 * 4 * 5, 0));
+    }
+
     SECTION("for_each_indexed"){
 
         SECTION("serial"){
@@ -448,6 +476,427 @@ TEST_CASE("algorithms"){
 
 
 
+TEST_CASE("Blocked traversal"){
+
+    size_type nk = 5;
+    size_type nj = 6;
+    size_type ni = 7;
+
+    std::vector<int> a(nk * nj * ni);
+    for (size_t i = 0; i < a.size(); ++i) { a[i] = int(i); }
+    std::vector<int> b(a.size(), 0);
+    std::vector<int> c(a.size(), 0);
+
+    auto temp = make_span(a, extents<3>{nk, nj, ni});
+    auto aa = make_subspan(temp,
+                           std::array<index_type, 3>{1, 1, 1},
+                           std::array<index_type, 3>{4, 5, 6});
+    auto bb = make_subspan(make_span(b, extents<3>{nk, nj, ni}),
+                           std::array<index_type, 3>{1, 1, 1},
+                           std::array<index_type, 3>{4, 5, 6});
+    auto cc = make_subspan(make_span(c, extents<3>{nk, nj, ni}),
+                           std::array<index_type, 3>{1, 1, 1},
+                           std::array<index_type, 3>{4, 5, 6});
+
+    SECTION("choose_block_size"){
+
+        std::array<index_type, 3> dims{64, 64, 128};
+        std::array<index_type, 3> min{-1, -1, -1};
+        std::array<index_type, 3> max{1, 1, 1};
+
+        auto big = detail::choose_block_size(dims, sizeof(double), min, max, Blocked<3>{});
+        CHECK(big == dims);
+
+        Blocked<3> small{{0, 0, 0}, 64 * 1024};
+        auto block = detail::choose_block_size(dims, sizeof(double), min, max, small);
+        CHECK(block[0] == dims[0]);
+        CHECK(block[1] < dims[1]);
+        CHECK(size_t(3 * (block[1] + 2) * (block[2] + 2)) * sizeof(double) <= small.cache_bytes / 2);
+
+        Blocked<3> fixed{{0, 3, 0}, 64 * 1024};
+        CHECK(detail::choose_block_size(dims, sizeof(double), min, max, fixed)[1] == 3);
+    }
+
+    SECTION("window_transform"){
+
+        auto op = [](auto f) {
+            return f(-1, 0, 0) + 2 * f(1, 0, 0) + 3 * f(0, -1, 1);
+        };
+
+        window_transform(aa, cc, op);
+
+        window_transform(std::execution::seq, aa, bb, op, Blocked<3>{{2, 3, 2}});
+        CHECK(b == c);
+
+        b.assign(b.size(), 0);
+        window_transform(std::execution::par, aa, bb, op, Blocked<3>{{0, 1, 0}, 64});
+        CHECK(b == c);
+    }
+
+    SECTION("tile_transform"){
+
+        auto op = [](auto f) {
+            return f(-1) + 2 * f(1);
+        };
+
+        tile_transform<0>(aa, cc, op);
+
+        tile_transform<0>(std::execution::seq, aa, bb, op, Blocked<3>{{1, 2, 2}});
+        CHECK(b == c);
+
+        b.assign(b.size(), 0);
+        tile_transform<0>(std::execution::par, aa, bb, op, Blocked<3>{});
+        CHECK(b == c);
+    }
+}
+
+TEST_CASE("Temporal blocking"){
+
+    size_type nj = 12;
+    size_type ni = 40;
+
+    std::vector<double> a(nj * ni);
+    for (size_t i = 0; i < a.size(); ++i) { a[i] = double(i % 7) - double(i % 3); }
+
+    std::array<index_type, 2> begin{2, 1};
+    std::array<index_type, 2> end{index_type(nj) - 2, index_type(ni) - 1};
+
+    auto op = [](auto f) {
+        return 0.25 * f(-2, 0) + 0.5 * f(0, 1) + 0.125 * f(0, -1) + 0.125 * f(1, 0);
+    };
+
+    //Reference, one sweep per step keeping the padding fixed
+    const size_t steps = 4;
+    std::vector<double> ref(a);
+    std::vector<double> tmp(a);
+    for (size_t s = 0; s < steps; ++s){
+        auto in = make_subspan(make_span(std::as_const(ref), extents<2>{nj, ni}), begin, end);
+        auto out = make_subspan(make_span(tmp, extents<2>{nj, ni}), begin, end);
+        window_transform(in, out, op);
+        std::swap(ref, tmp);
+    }
+
+    auto run = [&](auto policy, Blocked<2> traversal){
+        std::vector<double> b(a.size(), 0.0);
+        auto in = make_subspan(make_span(std::as_const(a), extents<2>{nj, ni}), begin, end);
+        auto out = make_subspan(make_span(b, extents<2>{nj, ni}), begin, end);
+        temporal_window_transform(policy, in, out, op, steps, traversal);
+        return b;
+    };
+
+    auto interior_equal = [&](const std::vector<double>& b){
+        auto s1 = make_subspan(make_span(std::as_const(ref), extents<2>{nj, ni}), begin, end);
+        auto s2 = make_subspan(make_span(b, extents<2>{nj, ni}), begin, end);
+        bool equal = true;
+        for (index_type j = 0; j < end[0] - begin[0]; ++j){
+        for (index_type i = 0; i < end[1] - begin[1]; ++i){
+            if (std::abs(s1(j, i) - s2(j, i)) > 1E-12) { equal = false; }
+        }}
+        return equal;
+    };
+
+    CHECK(interior_equal(run(std::execution::seq, Blocked<2>{})));
+    CHECK(interior_equal(run(std::execution::seq, Blocked<2>{{3, 5}})));
+    CHECK(interior_equal(run(std::execution::par, Blocked<2>{{1, 7}})));
+    CHECK(interior_equal(run(std::execution::par, Blocked<2>{{0, 0}, 256})));
+
+    SECTION("choose_tile_size"){
+        std::array<index_type, 3> dims{64, 64, 256};
+        std::array<index_type, 3> reach{8, 8, 8};
+
+        auto tile = detail::choose_tile_size(dims, sizeof(double), reach, Blocked<3>{{0, 0, 0}, 256 * 1024});
+        CHECK(tile[2] >= 32);
+        CHECK(2 * sizeof(double) * size_t((tile[0] + 8) * (tile[1] + 8) * (tile[2] + 8)) <= 256 * 1024);
+    }
+}
+
+TEST_CASE("Fused transform"){
+
+    size_type nj = 6;
+    size_type ni = 7;
+
+    std::vector<double> a(nj * ni);
+    for (size_t i = 0; i < a.size(); ++i) { a[i] = double(i * i % 11); }
+
+    std::array<index_type, 2> begin{1, 1};
+    std::array<index_type, 2> end{index_type(nj) - 1, index_type(ni) - 1};
+
+    auto in = make_subspan(make_span(std::as_const(a), extents<2>{nj, ni}), begin, end);
+
+    auto d2 = [](auto f) { return f(-1) - 2.0 * f(0) + f(1); };
+    auto diag = [](auto f) { return f(1, 1) - f(-1, -1); };
+
+    //Reference with separate sweeps and intermediate arrays
+    std::vector<double> ddx(a.size(), 0.0);
+    std::vector<double> ddy(a.size(), 0.0);
+    std::vector<double> dd(a.size(), 0.0);
+    tile_transform<0>(in, make_subspan(make_span(ddx, extents<2>{nj, ni}), begin, end), d2);
+    tile_transform<1>(in, make_subspan(make_span(ddy, extents<2>{nj, ni}), begin, end), d2);
+    window_transform(in, make_subspan(make_span(dd, extents<2>{nj, ni}), begin, end), diag);
+
+    std::vector<double> correct(a.size(), 0.0);
+    for (size_t i = 0; i < a.size(); ++i){
+        correct[i] = 0.5 * (ddx[i] + ddy[i]) - dd[i];
+    }
+
+    auto combiner = [](double x, double y, double d) {
+        return 0.5 * (x + y) - d;
+    };
+
+    SECTION("serial"){
+        std::vector<double> b(a.size(), 0.0);
+        auto out = make_subspan(make_span(b, extents<2>{nj, ni}), begin, end);
+        fused_transform(in, out, combiner, tile_term<0>(d2), tile_term<1>(d2), window_term(diag));
+        CHECK(b == correct);
+    }
+
+    SECTION("parallel"){
+        std::vector<double> b(a.size(), 0.0);
+        auto out = make_subspan(make_span(b, extents<2>{nj, ni}), begin, end);
+        fused_transform(std::execution::par_unseq, in, out, combiner, tile_term<0>(d2), tile_term<1>(d2), window_term(diag));
+        CHECK(b == correct);
+    }
+
+    SECTION("offsets"){
+        auto [min, max] = detail::fused_offsets<2>(tile_term<0>(d2), window_term(diag));
+        CHECK(min == std::array<index_type, 2>{-1, -1});
+        CHECK(max == std::array<index_type, 2>{1, 1});
+    }
+}
+
+TEST_CASE("SIMD tile transform"){
+
+    auto cd2 = [](auto f) { return f(-1) - 2.0 * f(0) + f(1); };
+    auto cd4 = [](auto f) {
+        return (-1.0 / 12.0) * f(-2) + (4.0 / 3.0) * f(-1) - 2.5 * f(0)
+             + (4.0 / 3.0) * f(1) - (1.0 / 12.0) * f(2);
+    };
+
+    SECTION("1D"){
+        size_type n = 23;
+        std::vector<double> a(n);
+        for (size_t i = 0; i < a.size(); ++i) { a[i] = double(i * i); }
+
+        auto in = make_subspan(make_span(std::as_const(a), extents<1>{n}),
+                               std::array<index_type, 1>{1},
+                               std::array<index_type, 1>{index_type(n) - 1});
+
+        std::vector<double> b(n, 0.0);
+        std::vector<double> c(n, 0.0);
+        tile_transform<0>(in, make_subspan(make_span(b, extents<1>{n}), std::array<index_type, 1>{1}, std::array<index_type, 1>{index_type(n) - 1}), cd2);
+        simd_tile_transform<0>(in, make_subspan(make_span(c, extents<1>{n}), std::array<index_type, 1>{1}, std::array<index_type, 1>{index_type(n) - 1}), cd2);
+        CHECK(b == c);
+    }
+
+    SECTION("float"){
+        size_type n = 37;
+        std::vector<float> a(n);
+        for (size_t i = 0; i < a.size(); ++i) { a[i] = float(i * i); }
+
+        auto in = make_subspan(make_span(std::as_const(a), extents<1>{n}),
+                               std::array<index_type, 1>{1},
+                               std::array<index_type, 1>{index_type(n) - 1});
+
+        auto out = [n](std::vector<float>& v){
+            return make_subspan(make_span(v, extents<1>{n}),
+                                std::array<index_type, 1>{1},
+                                std::array<index_type, 1>{index_type(n) - 1});
+        };
+
+        // Vectorized
+        auto cd2_int = [](auto f) { return f(-1) - 2 * f(0) + f(1); };
+        // Not invocable with float simd vectors, evaluated element-wise
+        auto cd2_double = [](auto f) -> decltype(float(f(0))) {
+            return float(double(f(-1)) - 2.0 * double(f(0)) + double(f(1)));
+        };
+
+        std::vector<float> b(n, 0.0f);
+        std::vector<float> c(n, 0.0f);
+        std::vector<float> d(n, 0.0f);
+        tile_transform<0>(in, out(b), cd2_int);
+        simd_tile_transform<0>(in, out(c), cd2_int);
+        simd_tile_transform<0>(std::execution::par_unseq, in, out(d), cd2_double);
+        CHECK(b == c);
+        CHECK(b == d);
+        CHECK(b[5] == 2.0f);
+    }
+
+    SECTION("3D"){
+        size_type nk = 7;
+        size_type nj = 8;
+        size_type ni = 19;
+        std::vector<double> a(nk * nj * ni);
+        for (size_t i = 0; i < a.size(); ++i) { a[i] = double(i % 13) * 0.5; }
+
+        std::array<index_type, 3> begin{2, 2, 2};
+        std::array<index_type, 3> end{5, 6, 17};
+
+        auto in = make_subspan(make_span(std::as_const(a), extents<3>{nk, nj, ni}), begin, end);
+
+        auto compare = [&](auto policy, auto dir){
+            constexpr size_t Dir = decltype(dir)::value;
+            std::vector<double> b(a.size(), 0.0);
+            std::vector<double> c(a.size(), 0.0);
+            tile_transform<Dir>(in, make_subspan(make_span(b, extents<3>{nk, nj, ni}), begin, end), cd4);
+            simd_tile_transform<Dir>(policy, in, make_subspan(make_span(c, extents<3>{nk, nj, ni}), begin, end), cd4);
+            bool equal = true;
+            for (size_t i = 0; i < b.size(); ++i){
+                if (std::abs(b[i] - c[i]) > 1E-12) { equal = false; }
+            }
+            return equal;
+        };
+
+        CHECK(compare(std::execution::seq, std::integral_constant<size_t, 0>{}));
+        CHECK(compare(std::execution::seq, std::integral_constant<size_t, 1>{}));
+        CHECK(compare(std::execution::seq, std::integral_constant<size_t, 2>{}));
+        CHECK(compare(std::execution::par_unseq, std::integral_constant<size_t, 2>{}));
+    }
+}
+
+TEST_CASE("Reductions"){
+
+    size_type nj = 5;
+    size_type ni = 7;
+    std::vector<int> a(nj * ni);
+    std::iota(a.begin(), a.end(), 0);
+
+    auto span = make_span(std::as_const(a), extents<2>{nj, ni});
+    auto inner = make_subspan(span, std::array<index_type, 2>{1, 1}, std::array<index_type, 2>{4, 6});
+
+    int inner_sum = 0;
+    for (index_type j = 1; j < 4; ++j){
+    for (index_type i = 1; i < 6; ++i){
+        inner_sum += a[size_t(j * index_type(ni) + i)];
+    }}
+
+    SECTION("reduce"){
+        CHECK(reduce(span, 0) == std::accumulate(a.begin(), a.end(), 0));
+        CHECK(reduce(std::execution::par, inner, 0) == inner_sum);
+        auto pair = make_subspan(span, std::array<index_type, 2>{1, 1}, std::array<index_type, 2>{2, 3});
+        CHECK(reduce(pair, 2, std::multiplies<>{}) == 2 * 8 * 9);
+        CHECK(reduce(std::execution::par_unseq, inner, -1, [](int x, int y) { return std::max(x, y); }) == 3 * int(ni) + 5);
+        CHECK(reduce(make_span(a, extents<1>{a.size()}), 1) == std::accumulate(a.begin(), a.end(), 1));
+    }
+
+    SECTION("transform_reduce"){
+        auto sq = [](int v) { return double(v) * double(v); };
+        double correct = 0.0;
+        for (auto v : a) { correct += sq(v); }
+        CHECK(transform_reduce(span, 0.0, std::plus<>{}, sq) == correct);
+        CHECK(transform_reduce(std::execution::par, span, 0.0, std::plus<>{}, sq) == correct);
+    }
+
+    SECTION("transform_reduce_indexed"){
+        auto count = transform_reduce_indexed(std::execution::par, inner, 0, std::plus<>{}, [=](auto idx, int v) {
+            return v == span(idx[0] + 1, idx[1] + 1) ? 1 : 0;
+        });
+        CHECK(count == 15);
+    }
+
+    SECTION("empty"){
+        auto empty = make_subspan(span, std::array<index_type, 2>{1, 1}, std::array<index_type, 2>{1, 6});
+        CHECK(reduce(empty, 42) == 42);
+    }
+}
+
+TEST_CASE("Multi reduction"){
+
+    size_type nj = 6;
+    size_type ni = 9;
+    std::vector<double> a(nj * ni);
+    for (size_t i = 0; i < a.size(); ++i) { a[i] = double(i % 7) - 3.5; }
+
+    auto span = make_span(std::as_const(a), extents<2>{nj, ni});
+
+    double sum = 0.0;
+    double squares = 0.0;
+    double max_abs = 0.0;
+    for (auto v : a) {
+        sum += v;
+        squares += v * v;
+        max_abs = std::max(max_abs, std::abs(v));
+    }
+
+    SECTION("norms"){
+        auto [l2, max, s] = multi_reduce(std::execution::par,
+                                         span,
+                                         sum_of_squares_reducer<double>(),
+                                         max_abs_reducer<double>(),
+                                         sum_reducer<double>());
+        CHECK(l2 == Approx(squares));
+        CHECK(max == max_abs);
+        CHECK(s == Approx(sum));
+    }
+
+    SECTION("custom reducers"){
+        auto count_negative = make_reducer(size_t(0), std::plus<>{}, [](double v) { return v < 0.0 ? size_t(1) : size_t(0); });
+        auto [count, min, max] = multi_reduce(span, count_negative, min_reducer<double>(), max_reducer<double>());
+        CHECK(count == size_t(std::count_if(a.begin(), a.end(), [](double v) { return v < 0.0; })));
+        CHECK(min == -3.5);
+        CHECK(max == 2.5);
+    }
+}
+
+TEST_CASE("Compile-time stencils"){
+
+    static constexpr Stencil<2, 5> laplace{
+        {{{-1, 0}, {0, -1}, {0, 0}, {0, 1}, {1, 0}}},
+        {1.0, 1.0, -4.0, 1.0, 1.0}};
+
+    static constexpr auto cd4 = make_tile_stencil<1, 2>(
+        std::array<index_type, 4>{-2, -1, 1, 2},
+        std::array<double, 4>{1.0 / 12.0, -2.0 / 3.0, 2.0 / 3.0, -1.0 / 12.0});
+
+    static_assert(laplace.begin_padding() == std::array<index_type, 2>{1, 1});
+    static_assert(laplace.end_padding() == std::array<index_type, 2>{1, 1});
+    static_assert(cd4.begin_padding() == std::array<index_type, 2>{0, 2});
+    static_assert(cd4.end_padding() == std::array<index_type, 2>{0, 2});
+
+    size_type nj = 8;
+    size_type ni = 11;
+    std::vector<double> a(nj * ni);
+    for (size_t i = 0; i < a.size(); ++i) { a[i] = double(i * 7 % 5) + 0.25 * double(i); }
+
+    std::array<index_type, 2> begin{2, 2};
+    std::array<index_type, 2> end{index_type(nj) - 2, index_type(ni) - 2};
+
+    auto in = make_subspan(make_span(std::as_const(a), extents<2>{nj, ni}), begin, end);
+
+    auto compare = [&](const auto& b, const auto& c){
+        bool equal = true;
+        for (size_t i = 0; i < b.size(); ++i){
+            if (std::abs(b[i] - c[i]) > 1E-12) { equal = false; }
+        }
+        return equal;
+    };
+
+    SECTION("laplace"){
+        std::vector<double> b(a.size(), 0.0);
+        std::vector<double> c(a.size(), 0.0);
+        auto op = [](auto f) {
+            return 0.5 * (f(-1, 0) + f(0, -1) - 4.0 * f(0, 0) + f(0, 1) + f(1, 0));
+        };
+        window_transform(in, make_subspan(make_span(b, extents<2>{nj, ni}), begin, end), op);
+        stencil_transform<laplace>(in, make_subspan(make_span(c, extents<2>{nj, ni}), begin, end), 0.5);
+        CHECK(compare(b, c));
+
+        c.assign(c.size(), 0.0);
+        stencil_transform<laplace>(std::execution::par, in, make_subspan(make_span(c, extents<2>{nj, ni}), begin, end), 0.5);
+        CHECK(compare(b, c));
+    }
+
+    SECTION("cd4"){
+        std::vector<double> b(a.size(), 0.0);
+        std::vector<double> c(a.size(), 0.0);
+        auto op = [](auto f) {
+            return (1.0 / 12.0) * f(-2) - (2.0 / 3.0) * f(-1) + (2.0 / 3.0) * f(1) - (1.0 / 12.0) * f(2);
+        };
+        tile_transform<1>(in, make_subspan(make_span(b, extents<2>{nj, ni}), begin, end), op);
+        stencil_transform<cd4>(in, make_subspan(make_span(c, extents<2>{nj, ni}), begin, end));
+        CHECK(compare(b, c));
+    }
+}
+
 TEST_CASE("Stencil operations"){
 
     SECTION("1D cd-2"){
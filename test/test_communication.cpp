@@ -1,5 +1,9 @@
 #include "catch.hpp"
 
+#include <cstdio>
+#include <fstream>
+#include <memory_resource>
+
 
 #include "include/jada.hpp"
 #include "test.hpp"
@@ -7,6 +11,18 @@
 
 using namespace jada;
 
+struct TestState {
+    double                rho;
+    std::array<double, 3> u;
+    int                   id;
+
+    bool operator==(const TestState& rhs) const = default;
+};
+
+template <>
+struct jada::mpi::MakeDatatype<TestState>
+    : jada::mpi::StructDatatype<&TestState::rho, &TestState::u, &TestState::id> {};
+
 
 
 
@@ -87,6 +103,62 @@ TEST_CASE("Test data exchange"){
 
     }
 
+    SECTION("Mpi nonblocking decomposed periodic box"){
+
+        const index_type nj = 4;
+        const index_type ni = 5;
+        const int rank = mpi::get_world_rank();
+
+        auto domain = Box<2>{{0,0}, {nj, ni}};
+        auto topo = decompose(domain, mpi::world_size(), {true, true});
+        std::array<index_type, 2> bpad{1, 2};
+        std::array<index_type, 2> epad{2, 1};
+
+        auto box = topo.get_boxes(rank).front().box;
+        auto padded = expand(box, bpad, epad);
+
+        std::vector<int> data(flat_size(padded.get_extent()), -1);
+        auto span = make_span(data, padded.get_extent());
+
+        auto global_value = [=](index_type j, index_type i){
+            j = (j + nj) % nj;
+            i = (i + ni) % ni;
+            return j * ni + i;
+        };
+
+        for (index_type j = box.begin[0]; j < box.end[0]; ++j){
+        for (index_type i = box.begin[1]; i < box.end[1]; ++i){
+            span(j - padded.begin[0], i - padded.begin[1]) = global_value(j, i);
+        }}
+
+        auto handle = mpi_send_receive_async(data, topo, bpad, epad, rank);
+
+        if (mpi::world_size() == 1){
+            //Periodic self-transfers are copied directly
+            CHECK(handle.message_count() == 0);
+        } else {
+            CHECK(handle.message_count() > 0);
+        }
+
+        SECTION("wait"){
+            handle.wait();
+        }
+        SECTION("test"){
+            while (!handle.test()) {}
+        }
+
+        CHECK(handle.is_complete());
+
+        bool all_correct = true;
+        for (index_type j = padded.begin[0]; j < padded.end[0]; ++j){
+        for (index_type i = padded.begin[1]; i < padded.end[1]; ++i){
+            auto val = span(j - padded.begin[0], i - padded.begin[1]);
+            if (val != global_value(j, i)) { all_correct = false; }
+        }}
+        CHECK(all_correct);
+
+    }
+
 
 }
 
@@ -141,6 +213,34 @@ TEST_CASE("mpi functions"){
         CHECK(recv == size_t(mpi::world_size()));
     }
 
+    SECTION("MakeDatatype"){
+
+        CHECK(mpi::type_size(mpi::MakeDatatype<double>{}()) == int(sizeof(double)));
+        CHECK(mpi::type_size(mpi::MakeDatatype<char>{}()) == int(sizeof(char)));
+        CHECK(mpi::type_size(mpi::MakeDatatype<std::complex<double>>{}()) == int(sizeof(std::complex<double>)));
+        CHECK(mpi::type_size(mpi::MakeDatatype<std::array<float, 3>>{}()) == int(3 * sizeof(float)));
+        CHECK(mpi::type_size(mpi::MakeDatatype<TestState>{}()) == int(4 * sizeof(double) + sizeof(int)));
+
+        //Cached
+        CHECK(mpi::MakeDatatype<TestState>{}() == mpi::MakeDatatype<TestState>{}());
+
+        double d = 0.5;
+        CHECK(mpi::all_sum_reduce(d) == 0.5 * mpi::world_size());
+
+        std::complex<float> c(1.0f, 2.0f);
+        CHECK(mpi::all_sum_reduce(c) == c * float(mpi::world_size()));
+
+        std::vector<TestState> send(3);
+        for (size_t i = 0; i < send.size(); ++i){
+            send[i] = TestState{double(i), {1.0, 2.0, 3.0}, int(i)};
+        }
+        std::vector<TestState> recv(3);
+        MPI_Sendrecv(send.data(), 3, mpi::MakeDatatype<TestState>{}(), mpi::get_world_rank(), 0,
+                     recv.data(), 3, mpi::MakeDatatype<TestState>{}(), mpi::get_world_rank(), 0,
+                     MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        CHECK(std::equal(recv.begin(), recv.end(), send.begin()));
+    }
+
 
 
 
@@ -308,6 +408,105 @@ TEST_CASE("Test DistributedArray")
 
 
 
+    SECTION("contiguous storage"){
+        auto arr = make_test_array(true);
+
+        const auto storage = arr.get_local_storage();
+        const auto& blocks = arr.get_local_data();
+        CHECK(blocks.size() == arr.get_local_subdomain_count());
+
+        for (const auto& block : blocks){
+            CHECK(block.data() >= storage.data());
+            CHECK(block.data() + block.size() <= storage.data() + storage.size());
+            CHECK(reinterpret_cast<std::uintptr_t>(block.data()) % JADA_ALIGNMENT == 0);
+        }
+
+        // Cached subspans
+        CHECK(make_subspans(arr).data() == make_subspans(arr).data());
+
+        // Copies view their own storage
+        auto copy = arr;
+        for (auto& block : copy.get_local_data()){
+            std::fill(block.begin(), block.end(), -1);
+        }
+        for (size_t i = 0; i < blocks.size(); ++i){
+            CHECK(copy.get_local_data()[i].data() != blocks[i].data());
+            CHECK(make_subspans(copy)[i](0, 0) == -1);
+            CHECK(make_subspans(arr)[i](0, 0) == mpi::get_world_rank() + 1);
+        }
+
+        // Moves keep the storage
+        const auto* first = storage.data();
+        auto moved = std::move(arr);
+        CHECK(moved.get_local_storage().data() == first);
+        for (auto s : make_subspans(moved)){
+            CHECK(s(0, 0) == mpi::get_world_rank() + 1);
+        }
+    }
+
+    SECTION("allocators"){
+
+        auto topo = make_test_topology();
+        int myrank = mpi::get_world_rank();
+        std::array<index_type, 2> bpad{0, 1};
+        std::array<index_type, 2> epad{0, 2};
+
+        DistributedArray<2, int, HugePageAllocator<int>> huge(
+            std::execution::par, myrank, topo, bpad, epad);
+        DistributedArray<2, int, DefaultInitAllocator<int>> def(
+            std::execution::par_unseq, myrank, topo, bpad, epad);
+        DistributedArray<2, int> aligned(myrank, topo, bpad, epad);
+
+        for (const auto& block : huge.get_local_data()){
+            CHECK(reinterpret_cast<std::uintptr_t>(block.data()) % JADA_ALIGNMENT == 0);
+            CHECK(std::all_of(block.begin(), block.end(), [](int e){return e == 0;}));
+        }
+        for (const auto& block : def.get_local_data()){
+            CHECK(std::all_of(block.begin(), block.end(), [](int e){return e == 0;}));
+        }
+        // Including the alignment gaps between the boxes
+        auto storage = huge.get_local_storage();
+        CHECK(std::all_of(storage.begin(), storage.end(), [](int e){return e == 0;}));
+
+        // Algorithms mix arrays with different allocators
+        for_each(aligned, [=](int& e){e = myrank + 1;});
+        transform(aligned, huge, [](int e){return e + 1;});
+        CHECK(reduce(huge, 0) == reduce(aligned, 0) + int(global_element_count(aligned)));
+
+        // Large allocations are placed on huge page boundaries
+        HugePageAllocator<char> alloc;
+        char* p = alloc.allocate(JADA_HUGE_PAGE_BYTES + 1);
+        CHECK(reinterpret_cast<std::uintptr_t>(p) % JADA_HUGE_PAGE_BYTES == 0);
+        alloc.deallocate(p, JADA_HUGE_PAGE_BYTES + 1);
+
+        // Uninitialized construction followed by an exchange
+        DistributedArray<2, int, HugePageAllocator<int>> uninit(
+            Uninitialized{}, myrank, topo, bpad, epad);
+        for (auto& block : uninit.get_local_data()){
+            std::fill(block.begin(), block.end(), myrank + 1);
+        }
+        mpi_send_receive(uninit);
+        CHECK(local_element_count(uninit) == local_element_count(aligned));
+
+        // Move assignment between arrays with unequal stateful allocators
+        // copies the elements to a new buffer
+        using pmr_array = DistributedArray<2, int, std::pmr::polymorphic_allocator<int>>;
+        std::pmr::monotonic_buffer_resource r1, r2;
+        pmr_array src(myrank, topo, bpad, epad, &r1);
+        pmr_array dst(myrank, topo, bpad, epad, &r2);
+        for_each(src, [](int& e){e = 2;});
+        dst = std::move(src);
+        auto dst_storage = dst.get_local_storage();
+        for (const auto& block : dst.get_local_data()){
+            CHECK(block.data() >= dst_storage.data());
+            CHECK(block.data() + block.size() <= dst_storage.data() + dst_storage.size());
+        }
+        CHECK(reduce(dst, 0) == 2 * int(global_element_count(dst)));
+
+        pmr_array moved(std::move(dst));
+        CHECK(reduce(moved, 0) == 2 * int(global_element_count(moved)));
+    }
+
     SECTION("make_subspans"){
 
         SECTION("unpadded"){
@@ -792,6 +991,729 @@ TEST_CASE("Test DistributedArray")
 
     
 
+    SECTION("exchange_temporal_window_transform"){
+
+        const index_type nj = 9;
+        const index_type ni = 10;
+        const Box<2> domain({0,0}, {nj, ni});
+        const auto topo = decompose(domain, mpi::world_size(), {true, true});
+
+        const size_t steps = 3;
+        std::array<index_type, 2> bpad{3, 3};
+        std::array<index_type, 2> epad{3, 6};
+
+        auto op = [](auto f) {
+            return f(-1, 0) + f(1, 0) - f(0, -1) + 2 * f(0, 2);
+        };
+
+        std::vector<int> data(size_t(nj * ni));
+        std::iota(data.begin(), data.end(), 0);
+
+        std::vector<int> correct(data);
+        for (size_t s = 0; s < steps; ++s){
+            std::vector<int> next(correct.size());
+            auto periodic = [&](index_type j, index_type i){
+                j = (j + nj) % nj;
+                i = (i + ni) % ni;
+                return correct[size_t(j * ni + i)];
+            };
+            for (index_type j = 0; j < nj; ++j){
+            for (index_type i = 0; i < ni; ++i){
+                next[size_t(j * ni + i)] = periodic(j - 1, i) + periodic(j + 1, i)
+                                         - periodic(j, i - 1) + 2 * periodic(j, i + 2);
+            }}
+            correct = next;
+        }
+
+        auto arr_a = distribute(data, topo, mpi::get_world_rank(), bpad, epad);
+        auto arr_b = distribute(data, topo, mpi::get_world_rank(), bpad, epad);
+
+        SECTION("serial"){
+            exchange_temporal_window_transform(arr_a, arr_b, op, steps);
+            CHECK(to_vector(arr_b) == correct);
+        }
+        SECTION("parallel tiled"){
+            exchange_temporal_window_transform(std::execution::par, arr_a, arr_b, op, steps, Blocked<2>{{2, 3}});
+            CHECK(to_vector(arr_b) == correct);
+        }
+    }
+
+    SECTION("exchange_and_compute"){
+
+        const index_type nj = 6;
+        const index_type ni = 7;
+        const Box<2> domain({0,0}, {nj, ni});
+        const auto topo = decompose(domain, mpi::world_size(), {true, true});
+
+        std::array<index_type, 2> bpad{1, 2};
+        std::array<index_type, 2> epad{2, 1};
+
+        std::vector<int> data(size_t(nj * ni));
+        std::iota(data.begin(), data.end(), 0);
+
+        auto periodic = [&](index_type j, index_type i){
+            j = (j + nj) % nj;
+            i = (i + ni) % ni;
+            return data[size_t(j * ni + i)];
+        };
+
+        auto arr_a = distribute(data, topo, mpi::get_world_rank(), bpad, epad);
+        auto arr_b = distribute(data, topo, mpi::get_world_rank(), bpad, epad);
+
+        SECTION("exchange_window_transform"){
+
+            auto op = [](auto f) {
+                return f(-1, 0) + 2 * f(1, 0) + 3 * f(0, -2) + 4 * f(2, 1);
+            };
+
+            std::vector<int> correct(data.size());
+            for (index_type j = 0; j < nj; ++j){
+            for (index_type i = 0; i < ni; ++i){
+                correct[size_t(j * ni + i)] = periodic(j - 1, i)
+                                            + 2 * periodic(j + 1, i)
+                                            + 3 * periodic(j, i - 2)
+                                            + 4 * periodic(j + 2, i + 1);
+            }}
+
+            SECTION("serial"){
+                exchange_window_transform(arr_a, arr_b, op);
+                CHECK(to_vector(arr_b) == correct);
+            }
+            SECTION("parallel"){
+                exchange_window_transform(std::execution::par_unseq, arr_a, arr_b, op);
+                CHECK(to_vector(arr_b) == correct);
+            }
+        }
+
+        SECTION("exchange_fused_transform"){
+
+            auto combiner = [](int x, int y) { return x - 3 * y; };
+
+            std::vector<int> correct(data.size());
+            for (index_type j = 0; j < nj; ++j){
+            for (index_type i = 0; i < ni; ++i){
+                int x = periodic(j - 1, i) + 2 * periodic(j + 2, i);
+                int y = periodic(j, i - 2) + periodic(j + 1, i + 1);
+                correct[size_t(j * ni + i)] = combiner(x, y);
+            }}
+
+            auto t0 = tile_term<0>([](auto f) { return f(-1) + 2 * f(2); });
+            auto w = window_term([](auto f) { return f(0, -2) + f(1, 1); });
+
+            exchange_fused_transform(arr_a, arr_b, combiner, t0, w);
+            CHECK(to_vector(arr_b) == correct);
+
+            for (auto& block : arr_b.get_local_data()){
+                std::fill(block.begin(), block.end(), 0);
+            }
+            exchange_fused_transform(std::execution::par, arr_a, arr_b, combiner, t0, w);
+            CHECK(to_vector(arr_b) == correct);
+        }
+
+        SECTION("exchange_stencil_transform"){
+
+            static constexpr Stencil<2, 4, int> st{
+                {{{-1, 0}, {2, 0}, {0, -2}, {2, 1}}},
+                {1, 2, 3, 4}};
+
+            std::vector<int> correct(data.size());
+            for (index_type j = 0; j < nj; ++j){
+            for (index_type i = 0; i < ni; ++i){
+                correct[size_t(j * ni + i)] = 2 * (periodic(j - 1, i)
+                                            + 2 * periodic(j + 2, i)
+                                            + 3 * periodic(j, i - 2)
+                                            + 4 * periodic(j + 2, i + 1));
+            }}
+
+            exchange_stencil_transform<st>(arr_a, arr_b, 2);
+            CHECK(to_vector(arr_b) == correct);
+
+            mpi_send_receive(arr_a);
+            for (auto& block : arr_b.get_local_data()){
+                std::fill(block.begin(), block.end(), 0);
+            }
+            stencil_transform<st>(std::execution::par, arr_a, arr_b, 2);
+            CHECK(to_vector(arr_b) == correct);
+        }
+
+        SECTION("exchange_tile_transform"){
+
+            auto op = [](auto f) {
+                return f(-1) + 2 * f(1);
+            };
+
+            std::vector<int> correct0(data.size());
+            std::vector<int> correct1(data.size());
+            for (index_type j = 0; j < nj; ++j){
+            for (index_type i = 0; i < ni; ++i){
+                correct0[size_t(j * ni + i)] = periodic(j - 1, i) + 2 * periodic(j + 1, i);
+                correct1[size_t(j * ni + i)] = periodic(j, i - 1) + 2 * periodic(j, i + 1);
+            }}
+
+            exchange_tile_transform<0>(std::execution::par, arr_a, arr_b, op);
+            CHECK(to_vector(arr_b) == correct0);
+
+            exchange_tile_transform<1>(arr_a, arr_b, op);
+            CHECK(to_vector(arr_b) == correct1);
+        }
+
+        SECTION("profiler"){
+
+            auto plan = make_exchange_plan(arr_a);
+
+            profiler().reset();
+            mpi_send_receive(arr_a, plan);
+            window_transform(arr_a, arr_b, [](auto f) { return f(0, 0); });
+
+            const auto& phases = profiler().phases();
+            CHECK(phases[size_t(Phase::Post)].calls == 1);
+            CHECK(phases[size_t(Phase::Pack)].calls == 1);
+            CHECK(phases[size_t(Phase::Wait)].calls == 1);
+            CHECK(phases[size_t(Phase::Unpack)].calls == 1);
+            CHECK(phases[size_t(Phase::Kernel)].calls == 1);
+
+            size_t sent = 0;
+            size_t received = 0;
+            for (const auto& [peer, n] : profiler().neighbours()){
+                CHECK(peer != mpi::get_world_rank());
+                sent += n.bytes_sent;
+                received += n.bytes_received;
+            }
+            CHECK(sent == detail::packed_size(plan.send_transfers()) * sizeof(int));
+            CHECK(received == detail::packed_size(plan.receive_transfers()) * sizeof(int));
+            CHECK(mpi::all_sum_reduce(int(sent)) == mpi::all_sum_reduce(int(received)));
+
+            auto csv = profile_report();
+            CHECK(csv.find("rank,phase,seconds,calls") != std::string::npos);
+            CHECK(csv.find("phase,min,max,mean,imbalance") != std::string::npos);
+
+            auto json = profile_report(ReportFormat::Json);
+            CHECK(json.find("\"summary\"") != std::string::npos);
+            CHECK(json.find("\"kernel\"") != std::string::npos);
+
+            profiler().reset();
+            CHECK(profiler().neighbours().empty());
+        }
+
+        SECTION("gather and write"){
+
+            const int root = mpi::world_size() - 1;
+
+            auto gathered = gather_to_root(arr_a, root);
+            if (mpi::get_world_rank() == root){
+                CHECK(gathered == data);
+            } else {
+                CHECK(gathered.empty());
+            }
+
+            // Streaming in slabs of at most 8 elements
+            std::vector<int> streamed(data.size(), -1);
+            size_t max_slab = 0;
+            gather_to_root(arr_a, [&](const Box<2>& region, auto span){
+                max_slab = std::max(max_slab, region.size());
+                for (index_type j = 0; j < index_type(span.extent(0)); ++j){
+                for (index_type i = 0; i < index_type(span.extent(1)); ++i){
+                    const auto gj = region.begin[0] + j;
+                    const auto gi = region.begin[1] + i;
+                    streamed[size_t(gj * ni + gi)] = span(j, i);
+                }}
+            }, root, 8);
+
+            if (mpi::get_world_rank() == root){
+                CHECK(streamed == data);
+                CHECK(max_slab <= 8);
+            } else {
+                CHECK(max_slab == 0);
+            }
+
+            const std::string fname = "jada_test_row_major.bin";
+            write_row_major(arr_a, fname);
+            if (mpi::get_world_rank() == 0){
+                std::vector<int> read(data.size());
+                std::ifstream in(fname, std::ios::binary);
+                in.read(reinterpret_cast<char*>(read.data()), std::streamsize(read.size() * sizeof(int)));
+                CHECK(in.gcount() == std::streamsize(read.size() * sizeof(int)));
+                CHECK(read == data);
+            }
+            mpi::wait();
+
+            // Read-only views over the mapped file
+            {
+                MappedFile<int> file(fname);
+                CHECK(file.size() == data.size());
+                CHECK(std::equal(file.begin(), file.end(), data.begin()));
+
+                auto spans = make_subspans(file, topo, mpi::get_world_rank());
+                auto boxes = topo.get_boxes(mpi::get_world_rank());
+                for (size_t k = 0; k < spans.size(); ++k){
+                    const auto& box = boxes[k].box;
+                    CHECK(spans[k](0, 0) == periodic(box.begin[0], box.begin[1]));
+                }
+
+                auto arr = distribute(file, topo, mpi::get_world_rank(), bpad, epad);
+                CHECK(to_vector(arr) == data);
+
+                // Offset mappings do not have to be page aligned
+                MappedFile<int> tail(fname, sizeof(int) * 3, 5);
+                CHECK(std::vector<int>(tail.begin(), tail.end()) == std::vector<int>{3, 4, 5, 6, 7});
+
+                CHECK_THROWS_AS(MappedFile<int>(fname, 2), std::runtime_error);
+                CHECK_THROWS_AS(MappedFile<int>(fname, sizeof(int) * (data.size() + 1)), std::runtime_error);
+                CHECK_THROWS_AS(MappedFile<int>("jada_test_missing.bin"), std::runtime_error);
+            }
+
+            mpi::wait();
+            if (mpi::get_world_rank() == 0){
+                std::remove(fname.c_str());
+            }
+        }
+
+        SECTION("scatter and generate"){
+
+            const int root = mpi::world_size() - 1;
+            const int rank = mpi::get_world_rank();
+
+            mpi_send_receive(arr_a);
+
+            SECTION("scatter_from_root"){
+                const std::vector<int> empty;
+                auto arr = scatter_from_root(rank == root ? data : empty, topo, rank, bpad, epad, root);
+                CHECK(to_vector(arr) == data);
+
+                mpi_send_receive(arr);
+                for (size_t i = 0; i < arr.get_local_subdomain_count(); ++i){
+                    const auto& l = arr.get_local_data()[i];
+                    const auto& r = arr_a.get_local_data()[i];
+                    CHECK(std::equal(l.begin(), l.end(), r.begin()));
+                }
+            }
+
+            SECTION("generator"){
+                auto index = [=](auto idx){
+                    return int(std::get<0>(idx) * ni + std::get<1>(idx));
+                };
+
+                auto s_arr = distribute<int>(topo, rank, bpad, epad, index);
+                auto p_arr = distribute<int>(std::execution::par_unseq, topo, rank, bpad, epad, index);
+                CHECK(to_vector(s_arr) == data);
+                CHECK(to_vector(p_arr) == data);
+
+                mpi_send_receive(p_arr);
+                for (size_t i = 0; i < p_arr.get_local_subdomain_count(); ++i){
+                    const auto& l = p_arr.get_local_data()[i];
+                    const auto& r = arr_a.get_local_data()[i];
+                    CHECK(std::equal(l.begin(), l.end(), r.begin()));
+                }
+            }
+        }
+
+        SECTION("checkpoint"){
+
+            const std::string fname = "jada_test_checkpoint.bin";
+            write_checkpoint(arr_a, fname);
+
+            auto info = read_checkpoint_info<2>(fname);
+            CHECK(info.topology.get_domain() == domain);
+            CHECK(info.topology.get_boxes() == topo.get_boxes());
+            CHECK(info.topology.get_periods() == topo.get_periods());
+            CHECK(info.begin_padding == bpad);
+            CHECK(info.end_padding == epad);
+            CHECK(info.element_size == sizeof(int));
+            CHECK(info.element_kind == CheckpointElementKind::signed_integer);
+
+            SECTION("same topology"){
+                auto restarted = read_checkpoint<2, int>(fname, mpi::get_world_rank());
+                CHECK(to_vector(restarted) == data);
+                CHECK(restarted.get_begin_padding() == bpad);
+            }
+
+            SECTION("different topology"){
+                // One box per row distributed round robin
+                std::vector<BoxRankPair<2>> boxes;
+                for (index_type j = 0; j < nj; ++j){
+                    boxes.push_back({Box<2>({j, 0}, {j + 1, ni}), j % mpi::world_size()});
+                }
+                Topology<2> other(domain, boxes, {true, true});
+
+                auto restarted = read_checkpoint<2, int, HugePageAllocator<int>>(
+                    fname, other, mpi::get_world_rank(), {0, 1}, {0, 1});
+                CHECK(to_vector(restarted) == data);
+
+                mpi_send_receive(restarted);
+                for (auto s : make_subspans(restarted)){
+                    CHECK(s(0, -1) == s(0, ni - 1));
+                }
+            }
+
+            SECTION("invalid"){
+                // Mismatching element types and domains
+                CHECK_THROWS_AS((read_checkpoint<2, float>(fname, mpi::get_world_rank())), std::runtime_error);
+                CHECK_THROWS_AS((read_checkpoint<2, unsigned>(fname, mpi::get_world_rank())), std::runtime_error);
+                CHECK_THROWS_AS(read_checkpoint_info<3>(fname), std::runtime_error);
+                auto small = decompose(Box<2>({0, 0}, {nj, ni - 1}), mpi::world_size(), {true, true});
+                CHECK_THROWS_AS((read_checkpoint<2, int>(fname, small, mpi::get_world_rank(), bpad, epad)), std::runtime_error);
+
+                // Not a checkpoint and a corrupted header size
+                const std::string garbage = "jada_test_garbage.bin";
+                if (mpi::get_world_rank() == 0){
+                    std::ofstream out(garbage, std::ios::binary);
+                    out << std::string(200, 'x');
+                    out.flush();
+
+                    std::ifstream in(fname, std::ios::binary);
+                    std::vector<char> bytes(200);
+                    in.read(bytes.data(), 200);
+                    std::fill(bytes.begin() + 40, bytes.begin() + 48, char(0x7f));
+                    std::ofstream corrupt(garbage + "2", std::ios::binary);
+                    corrupt.write(bytes.data(), 200);
+                }
+                mpi::wait();
+                CHECK_THROWS_AS(read_checkpoint_info<2>(garbage), std::runtime_error);
+                CHECK_THROWS_AS(read_checkpoint_info<2>(garbage + "2"), std::runtime_error);
+                CHECK_THROWS_AS((MappedCheckpoint<2, int>(garbage)), std::runtime_error);
+                CHECK_THROWS_AS((MappedCheckpoint<2, int>(garbage + "2")), std::runtime_error);
+                CHECK_THROWS_AS((MappedCheckpoint<2, float>(fname)), std::runtime_error);
+                mpi::wait();
+                if (mpi::get_world_rank() == 0){
+                    std::remove(garbage.c_str());
+                    std::remove((garbage + "2").c_str());
+                }
+            }
+
+            SECTION("mapped"){
+                MappedCheckpoint<2, int> mapped(fname);
+                CHECK(mapped.info().topology.get_boxes() == topo.get_boxes());
+                CHECK_THROWS_AS(mapped.get_box(topo.get_boxes().size()), std::out_of_range);
+
+                auto spans = make_subspans(mapped, mpi::get_world_rank());
+                auto local = make_subspans(arr_a);
+                REQUIRE(spans.size() == local.size());
+                for (size_t k = 0; k < spans.size(); ++k){
+                    CHECK(dimensions(spans[k]) == dimensions(local[k]));
+                    for (size_t j = 0; j < spans[k].extent(0); ++j){
+                    for (size_t i = 0; i < spans[k].extent(1); ++i){
+                        CHECK(spans[k](j, i) == local[k](j, i));
+                    }}
+                }
+            }
+
+            mpi::wait();
+            if (mpi::get_world_rank() == 0){
+                std::remove(fname.c_str());
+            }
+        }
+
+        SECTION("reductions"){
+
+            // Non-zero padding which should not be visited
+            mpi_send_receive(arr_a);
+
+            const int sum = std::accumulate(data.begin(), data.end(), 0);
+            long squares = 0;
+            for (auto v : data) { squares += long(v) * long(v); }
+
+            CHECK(reduce(arr_a, 0) == sum);
+            CHECK(reduce(std::execution::par, arr_a, 3) == sum + 3);
+            CHECK(transform_reduce(std::execution::par, arr_a, 0L, std::plus<>{}, [](int v) { return long(v) * long(v); }) == squares);
+
+            auto max = [](int a, int b) { return std::max(a, b); };
+            CHECK(reduce(arr_a, -1, max) == nj * ni - 1);
+            CHECK(reduce(arr_a, 1000, max) == 1000);
+
+            auto mismatches = transform_reduce_indexed(arr_a, 0, std::plus<>{}, [&](auto idx, int v) {
+                return v == periodic(std::get<0>(idx), std::get<1>(idx)) ? 0 : 1;
+            });
+            CHECK(mismatches == 0);
+
+            int fact = 1;
+            for (int i = 1; i <= mpi::world_size(); ++i) { fact *= i; }
+            CHECK(mpi::all_reduce(mpi::get_world_rank() + 1, std::multiplies<>{}) == fact);
+            CHECK(mpi::all_reduce(mpi::get_world_rank(), max) == mpi::world_size() - 1);
+            CHECK(mpi::all_reduce(mpi::get_world_rank(), Minimum{}) == 0);
+        }
+
+        SECTION("multi_reduce"){
+
+            mpi_send_receive(arr_a);
+
+            long squares = 0;
+            for (auto v : data) { squares += long(v) * long(v); }
+
+            auto [l2, max, sum, min] = multi_reduce(std::execution::par,
+                                                    arr_a,
+                                                    sum_of_squares_reducer<long>(),
+                                                    max_abs_reducer<int>(),
+                                                    sum_reducer<double>(),
+                                                    min_reducer<int>());
+            CHECK(l2 == squares);
+            CHECK(max == nj * ni - 1);
+            CHECK(sum == double(std::accumulate(data.begin(), data.end(), 0)));
+            CHECK(min == 0);
+
+            auto [count] = multi_reduce(arr_a, make_reducer(0, std::plus<>{}, [](int) { return 1; }));
+            CHECK(count == nj * ni);
+        }
+
+        SECTION("ExchangePlan"){
+
+            auto plan = make_exchange_plan(arr_a);
+
+            CHECK(plan.message_count() <= plan.send_transfers().size() + plan.receive_transfers().size());
+            CHECK(plan.message_count() <= 2 * size_t(mpi::world_size()));
+
+            if (mpi::world_size() == 1){
+                CHECK(plan.message_count() == 0);
+                CHECK(!plan.local_transfers().empty());
+            }
+
+            //One message per neighbour covering all the transfers
+            size_t count = 0;
+            const auto& messages = plan.send_messages();
+            for (size_t i = 0; i < messages.size(); ++i){
+                if (i > 0) { CHECK(messages[i - 1].peer < messages[i].peer); }
+                count += messages[i].count;
+            }
+            CHECK(count == detail::packed_size(plan.send_transfers()));
+
+            auto check_padding = [&](const auto& arr, int shift){
+                bool all_correct = true;
+                auto boxes = arr.get_local_boxes();
+                for (size_t n = 0; n < boxes.size(); ++n){
+                    auto padded = expand(boxes[n].box, bpad, epad);
+                    auto span = make_span(arr.get_local_data()[n], padded.get_extent());
+                    for (index_type j = padded.begin[0]; j < padded.end[0]; ++j){
+                    for (index_type i = padded.begin[1]; i < padded.end[1]; ++i){
+                        if (span(j - padded.begin[0], i - padded.begin[1]) != periodic(j, i) + shift){
+                            all_correct = false;
+                        }
+                    }}
+                }
+                return all_correct;
+            };
+
+            for (int iter = 0; iter < 3; ++iter){
+                for_each(arr_a, [](auto& e){ e += 1; });
+                mpi_send_receive(arr_a, plan);
+                CHECK(check_padding(arr_a, iter + 1));
+            }
+
+            for_each(arr_b, [](auto& e){ e += 5; });
+            auto& req = mpi_send_receive_async(arr_b, plan);
+            CHECK(!req.is_complete());
+            while (!req.test()) {}
+            CHECK(check_padding(arr_b, 5));
+
+            // Dropping plans with a running exchange completes the exchange
+            for (auto method : {ExchangeMethod::Pack, ExchangeMethod::Subarray}){
+                for_each(arr_b, [](auto& e){ e += 1; });
+                {
+                    auto dropped = make_exchange_plan(arr_b, method);
+                    mpi_send_receive_async(arr_b, dropped);
+                }
+            }
+            CHECK(check_padding(arr_b, 7));
+        }
+
+        SECTION("ExchangePlan subarray"){
+
+            auto plan = make_exchange_plan(arr_a, ExchangeMethod::Subarray);
+
+            CHECK(plan.method() == ExchangeMethod::Subarray);
+            CHECK(plan.message_count() <= plan.send_transfers().size() + plan.receive_transfers().size());
+            CHECK(plan.message_count() <= 2 * size_t(mpi::world_size()));
+
+            auto check_padding = [&](const auto& arr, int shift){
+                bool all_correct = true;
+                auto boxes = arr.get_local_boxes();
+                for (size_t n = 0; n < boxes.size(); ++n){
+                    auto padded = expand(boxes[n].box, bpad, epad);
+                    auto span = make_span(arr.get_local_data()[n], padded.get_extent());
+                    for (index_type j = padded.begin[0]; j < padded.end[0]; ++j){
+                    for (index_type i = padded.begin[1]; i < padded.end[1]; ++i){
+                        if (span(j - padded.begin[0], i - padded.begin[1]) != periodic(j, i) + shift){
+                            all_correct = false;
+                        }
+                    }}
+                }
+                return all_correct;
+            };
+
+            //Alternate the arrays so that the requests get rebound
+            for (int iter = 0; iter < 2; ++iter){
+                for_each(arr_a, [](auto& e){ e += 1; });
+                mpi_send_receive(arr_a, plan);
+                CHECK(check_padding(arr_a, iter + 1));
+
+                for_each(arr_b, [](auto& e){ e += 2; });
+                auto& req = mpi_send_receive_async(arr_b, plan);
+                while (!req.test()) {}
+                CHECK(check_padding(arr_b, 2 * (iter + 1)));
+            }
+        }
+
+        SECTION("non-int elements"){
+
+            std::vector<TestState> states(data.size());
+            for (size_t i = 0; i < data.size(); ++i){
+                double v = 0.5 * data[i];
+                states[i] = TestState{v, {v, -v, 2 * v}, data[i]};
+            }
+
+            auto rank = mpi::get_world_rank();
+            auto arr_d = distribute(std::vector<double>(states.size(), 0.0), topo, rank, bpad, epad);
+            auto arr_s = distribute(states, topo, rank, bpad, epad);
+            for_each(arr_d, [](auto& e){ e = 0.25; });
+
+            auto plan_d = make_exchange_plan(arr_d, ExchangeMethod::Subarray);
+            auto plan_s = make_exchange_plan(arr_s, ExchangeMethod::Pack);
+
+            mpi_send_receive(arr_d, plan_d);
+            mpi_send_receive(arr_s, plan_s);
+
+            bool all_correct = true;
+            auto boxes = arr_s.get_local_boxes();
+            for (size_t n = 0; n < boxes.size(); ++n){
+                auto padded = expand(boxes[n].box, bpad, epad);
+                auto span_d = make_span(arr_d.get_local_data()[n], padded.get_extent());
+                auto span_s = make_span(arr_s.get_local_data()[n], padded.get_extent());
+                for (index_type j = padded.begin[0]; j < padded.end[0]; ++j){
+                for (index_type i = padded.begin[1]; i < padded.end[1]; ++i){
+                    auto jj = j - padded.begin[0];
+                    auto ii = i - padded.begin[1];
+                    if (span_d(jj, ii) != 0.25){
+                        all_correct = false;
+                    }
+                    if (span_s(jj, ii).id != periodic(j, i) || span_s(jj, ii).u[2] != periodic(j, i)){
+                        all_correct = false;
+                    }
+                }}
+            }
+            CHECK(all_correct);
+        }
+
+        SECTION("batched"){
+
+            auto rank = mpi::get_world_rank();
+
+            std::vector<double> ddata(data.begin(), data.end());
+            std::vector<std::array<int, 2>> adata(data.size());
+            for (size_t i = 0; i < data.size(); ++i){
+                adata[i] = {data[i], -data[i]};
+            }
+            auto arr_d = distribute(ddata, topo, rank, bpad, epad);
+            auto arr_p = distribute(adata, topo, rank, bpad, epad);
+
+            auto check_padding = [&](int shift){
+                bool all_correct = true;
+                auto boxes = arr_a.get_local_boxes();
+                for (size_t n = 0; n < boxes.size(); ++n){
+                    auto padded = expand(boxes[n].box, bpad, epad);
+                    auto span_a = make_span(arr_a.get_local_data()[n], padded.get_extent());
+                    auto span_d = make_span(arr_d.get_local_data()[n], padded.get_extent());
+                    auto span_p = make_span(arr_p.get_local_data()[n], padded.get_extent());
+                    for (index_type j = padded.begin[0]; j < padded.end[0]; ++j){
+                    for (index_type i = padded.begin[1]; i < padded.end[1]; ++i){
+                        auto jj = j - padded.begin[0];
+                        auto ii = i - padded.begin[1];
+                        auto correct = periodic(j, i) + shift;
+                        if (span_a(jj, ii) != correct) { all_correct = false; }
+                        if (span_d(jj, ii) != double(correct)) { all_correct = false; }
+                        if (span_p(jj, ii)[1] != -correct) { all_correct = false; }
+                    }}
+                }
+                return all_correct;
+            };
+
+            auto arrays = std::tie(arr_a, arr_d, arr_p);
+
+            SECTION("one-shot"){
+                mpi_send_receive(arrays);
+                CHECK(check_padding(0));
+            }
+
+            SECTION("plan"){
+                auto plan = make_exchange_plan(arrays);
+                auto single = make_exchange_plan(arr_a);
+                CHECK(plan.message_count() == single.message_count());
+
+                for (int iter = 1; iter < 3; ++iter){
+                    for_each(arr_a, [](auto& e){ e += 1; });
+                    for_each(arr_d, [](auto& e){ e += 1.0; });
+                    for_each(arr_p, [](auto& e){ e[0] += 1; e[1] -= 1; });
+                    auto& req = mpi_send_receive_async(arrays, plan);
+                    req.wait();
+                    CHECK(check_padding(iter));
+                }
+            }
+
+            SECTION("dropped plan"){
+                for_each(arr_a, [](auto& e){ e += 1; });
+                for_each(arr_d, [](auto& e){ e += 1.0; });
+                for_each(arr_p, [](auto& e){ e[0] += 1; e[1] -= 1; });
+                {
+                    auto plan = make_exchange_plan(arrays);
+                    mpi_send_receive_async(arrays, plan);
+                }
+                CHECK(check_padding(1));
+            }
+        }
+
+        SECTION("parallel pack/unpack"){
+
+            auto check_padding = [&](const auto& arr){
+                bool all_correct = true;
+                auto boxes = arr.get_local_boxes();
+                for (size_t n = 0; n < boxes.size(); ++n){
+                    auto padded = expand(boxes[n].box, bpad, epad);
+                    auto span = make_span(arr.get_local_data()[n], padded.get_extent());
+                    for (index_type j = padded.begin[0]; j < padded.end[0]; ++j){
+                    for (index_type i = padded.begin[1]; i < padded.end[1]; ++i){
+                        if (span(j - padded.begin[0], i - padded.begin[1]) != periodic(j, i)){
+                            all_correct = false;
+                        }
+                    }}
+                }
+                return all_correct;
+            };
+
+            SECTION("one-shot"){
+                mpi_send_receive(std::execution::par_unseq, arr_a);
+                CHECK(check_padding(arr_a));
+            }
+            SECTION("plan"){
+                auto plan = make_exchange_plan(arr_a);
+                mpi_send_receive(std::execution::par, arr_a, plan);
+                CHECK(check_padding(arr_a));
+            }
+            SECTION("batched"){
+                auto arrays = std::tie(arr_a, arr_b);
+                auto plan = make_exchange_plan(arrays);
+                mpi_send_receive(std::execution::par_unseq, arrays, plan);
+                CHECK(check_padding(arr_a));
+                CHECK(check_padding(arr_b));
+            }
+        }
+
+        SECTION("mpi_send_receive"){
+
+            mpi_send_receive(arr_a);
+
+            bool all_correct = true;
+            auto boxes = arr_a.get_local_boxes();
+            for (size_t n = 0; n < boxes.size(); ++n){
+                auto padded = expand(boxes[n].box, bpad, epad);
+                auto span = make_span(arr_a.get_local_data()[n], padded.get_extent());
+                for (index_type j = padded.begin[0]; j < padded.end[0]; ++j){
+                for (index_type i = padded.begin[1]; i < padded.end[1]; ++i){
+                    if (span(j - padded.begin[0], i - padded.begin[1]) != periodic(j, i)){
+                        all_correct = false;
+                    }
+                }}
+            }
+            CHECK(all_correct);
+        }
+    }
+
     SECTION("boundary_algorithms"){
 
         index_type ni = 4;
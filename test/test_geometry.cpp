@@ -139,6 +139,48 @@ TEST_CASE("Test box") {
         CHECK(distance(b1, b2) == std::array<index_type, 3>{2, 2, 2});
         CHECK(distance(b1, b3) == std::array<index_type, 3>{1, 2, 3});
     }
+
+    SECTION("difference") {
+
+        SECTION("Test 1") {
+            Box<2> outer({0, 0}, {4, 5});
+            Box<2> inner({1, 2}, {3, 4});
+
+            auto boxes = difference(outer, inner);
+
+            CHECK(boxes.size() == 4);
+
+            index_type vol = 0;
+            for (const auto& b : boxes) {
+                CHECK(!have_overlap(b, inner));
+                CHECK(intersection(b, outer) == b);
+                vol += volume(b);
+            }
+            CHECK(vol == volume(outer) - volume(inner));
+        }
+
+        SECTION("Test 2") {
+            Box<3> outer({0, 0, 0}, {3, 3, 3});
+            Box<3> inner({0, 1, 0}, {3, 2, 3});
+
+            auto boxes = difference(outer, inner);
+
+            CHECK(boxes.size() == 2);
+            CHECK(boxes[0] == Box<3>({0, 0, 0}, {3, 1, 3}));
+            CHECK(boxes[1] == Box<3>({0, 2, 0}, {3, 3, 3}));
+        }
+
+        SECTION("Empty inner") {
+            Box<2> outer({0, 0}, {4, 5});
+            Box<2> inner({2, 2}, {2, 2});
+
+            auto boxes = difference(outer, inner);
+
+            index_type vol = 0;
+            for (const auto& b : boxes) { vol += volume(b); }
+            CHECK(vol == volume(outer));
+        }
+    }
 }
 
 
@@ -703,6 +745,100 @@ TEST_CASE("Test decomposition"){
 
 
 
+TEST_CASE("Test recursive bisection"){
+
+    auto max_load = [](const auto& topo, auto weight){
+        double max = 0;
+        for (const auto& pair : topo.get_boxes()){
+            double w = 0;
+            for (auto md_idx : md_indices(pair.box.begin, pair.box.end)){
+                w += weight(tuple_to_array(md_idx));
+            }
+            max = std::max(max, w);
+        }
+        return max;
+    };
+
+    SECTION("valid for any rank count"){
+        const Box<3> domain({0,0,0}, {10, 11, 12});
+
+        for (int n = 1; n <= 17; ++n){
+            const auto topo = decompose_bisection(domain, n, {true, false, true});
+
+            REQUIRE(topo.get_boxes().size() == size_t(n));
+            CHECK(topo.is_valid());
+            CHECK(topo.get_max_rank() == n - 1);
+            CHECK(topo.get_periods() == std::array<bool, 3>{true, false, true});
+
+            // Cuts are restricted to whole slabs of a small domain
+            const double mean = double(domain.size()) / double(n);
+            CHECK(max_load(topo, UniformWeight{}) <= 1.2 * mean);
+        }
+    }
+
+    SECTION("near one cell per rank"){
+        auto check = [](auto domain, int n){
+            const auto topo = decompose_bisection(domain, n, {false, false});
+            CHECK(topo.get_boxes().size() == size_t(n));
+            CHECK(topo.is_valid());
+            for (const auto& pair : topo.get_boxes()){
+                CHECK(pair.box.size() > 0);
+            }
+        };
+
+        check(Box<2>({0,0}, {3, 3}), 8);
+        check(Box<2>({0,0}, {3, 3}), 9);
+        check(Box<2>({0,0}, {10, 10}), 97);
+        check(Box<2>({0,0}, {10, 10}), 100);
+        check(Box<2>({0,0}, {1, 7}), 7);
+
+        CHECK_THROWS_AS(decompose_bisection(Box<2>({0,0}, {3, 3}), 10, {false, false}), std::runtime_error);
+        CHECK_THROWS_AS(decompose_bisection(Box<2>({0,0}, {3, 3}), 0, {false, false}), std::runtime_error);
+    }
+
+    SECTION("better balance than decompose for awkward rank counts"){
+        const Box<2> domain({0,0}, {12, 12});
+        const auto grid = decompose(domain, 7, {false, false});
+        const auto rcb = decompose_bisection(domain, 7, {false, false});
+        CHECK(max_load(rcb, UniformWeight{}) < max_load(grid, UniformWeight{}));
+    }
+
+    SECTION("weighted"){
+        const Box<2> domain({0,0}, {40, 30});
+        auto weight = [](auto idx){ return idx[1] < 10 ? 10.0 : 1.0; };
+
+        double total = 0;
+        for (auto md_idx : md_indices(domain.begin, domain.end)){
+            total += weight(tuple_to_array(md_idx));
+        }
+
+        for (int n : {3, 5, 8}){
+            const auto topo = decompose_bisection(domain, n, {false, false}, weight);
+            CHECK(topo.is_valid());
+            CHECK(max_load(topo, weight) <= 1.1 * total / n);
+
+            // Uniform boxes would be badly balanced
+            const auto uniform = decompose_bisection(domain, n, {false, false});
+            CHECK(max_load(topo, weight) < max_load(uniform, weight));
+        }
+    }
+
+    SECTION("minimize_surface"){
+        const Box<2> domain({0,0}, {101, 10});
+
+        BisectionOptions balance{};
+        balance.minimize_surface = false;
+
+        const auto surface = decompose_bisection(domain, 2, {false, false});
+        const auto balanced = decompose_bisection(domain, 2, {false, false}, balance);
+
+        // Cut across the short direction
+        CHECK(surface.get_boxes()[0].box == Box<2>({0, 0}, {50, 10}));
+        // Exact balance by cutting the long direction
+        CHECK(balanced.get_boxes()[0].box == Box<2>({0, 0}, {101, 5}));
+    }
+}
+
 TEST_CASE("min_max_offset"){
 
 
@@ -752,5 +888,18 @@ TEST_CASE("min_max_offset"){
 
     }
 
+    SECTION("md_min_max_offset"){
+
+        auto op = [](auto f){
+            return f(-1, 0) + f(0, 2) + f(3, -2);
+        };
+
+        auto [min, max] = md_min_max_offset<2>(op);
+
+        CHECK(min == std::array<index_type, 2>{-1, -2});
+        CHECK(max == std::array<index_type, 2>{3, 2});
+
+    }
+
 }
 